@@ -21,4 +21,13 @@ REM Build lib
 cl.exe /nologo /EHsc /Zi /GL /O2 /MT /FC /W4 /WX /wd4100 /wd4189 /D_CRT_SECURE_NO_WARNINGS /c ../src/tiny-gizmo.cpp ../src/tiny-gizmo-c.cpp
 lib.exe /NOLOGO /OUT:tiny-gizmo.lib tiny-gizmo.obj tiny-gizmo-c.obj
 
+REM Build and run tests, also with the SIMD math and the fast trigonometry enabled; run any with --bench for the benchmarks
+if not exist tests mkdir tests
+cl.exe /nologo /EHsc /O2 /MT /FC /W4 /WX /wd4100 /wd4189 /D_CRT_SECURE_NO_WARNINGS /Fotests\ ../tests/*.cpp ../src/tiny-gizmo.cpp /link /NOLOGO /OUT:tests\tests.exe /INCREMENTAL:NO || exit /b
+cl.exe /nologo /EHsc /O2 /MT /FC /W4 /WX /wd4100 /wd4189 /D_CRT_SECURE_NO_WARNINGS /DTINYGIZMO_SIMD /Fotests\ ../tests/*.cpp ../src/tiny-gizmo.cpp /link /NOLOGO /OUT:tests\tests-simd.exe /INCREMENTAL:NO || exit /b
+cl.exe /nologo /EHsc /O2 /MT /FC /W4 /WX /wd4100 /wd4189 /D_CRT_SECURE_NO_WARNINGS /DTINYGIZMO_FAST_TRIG /Fotests\ ../tests/*.cpp ../src/tiny-gizmo.cpp /link /NOLOGO /OUT:tests\tests-fast-trig.exe /INCREMENTAL:NO || exit /b
+tests\tests.exe || exit /b
+tests\tests-simd.exe || exit /b
+tests\tests-fast-trig.exe || exit /b
+
 popd
\ No newline at end of file
@@ -150,11 +150,11 @@ void draw_lit_mesh(GlShader& shader, GlMesh& mesh, const linalg::aliases::float3
 
 void upload_mesh(const geometry_mesh& cpu, GlMesh& gpu)
 {
-    gpu.set_vertices(reinterpret_cast<const std::vector<linalg::aliases::float3>&>(cpu.vertices), GL_DYNAMIC_DRAW);
+    gpu.set_vertices(cpu.vertices, GL_DYNAMIC_DRAW);
     gpu.set_attribute(0, 3, GL_FLOAT, GL_FALSE, sizeof(TG_GeometryVertex), (GLvoid*)offsetof(TG_GeometryVertex, position));
     gpu.set_attribute(1, 3, GL_FLOAT, GL_FALSE, sizeof(TG_GeometryVertex), (GLvoid*)offsetof(TG_GeometryVertex, normal));
     gpu.set_attribute(2, 4, GL_FLOAT, GL_FALSE, sizeof(TG_GeometryVertex), (GLvoid*)offsetof(TG_GeometryVertex, color));
-    gpu.set_elements(reinterpret_cast<const std::vector<linalg::aliases::uint3>&>(cpu.triangles), GL_DYNAMIC_DRAW);
+    gpu.set_elements((GLsizei)cpu.triangles.size(), tinygizmo::math_cast<linalg::aliases::uint3>(cpu.triangles.data()), GL_DYNAMIC_DRAW);
 }
 
 // Callback function for rendering gizmo geometry
@@ -205,22 +205,9 @@ linalg::aliases::float4x4 get_transform_matrix(TG_RigidTransform transform)
     TG_GetRigidTransformOrientation(transform, &orientation);
     TG_GetRigidTransformScale(transform, &scale);
     
-    // Convert to minalg types for matrix calculation
-    minalg::float3 pos = {position.x, position.y, position.z};
-    minalg::float4 orient = {orientation.x, orientation.y, orientation.z, orientation.w};
-    minalg::float3 scl = {scale.x, scale.y, scale.z};
-    
-    // Calculate matrix using minalg functions
-    minalg::float3 x_axis = qxdir(orient) * scl.x;
-    minalg::float3 y_axis = qydir(orient) * scl.y;
-    minalg::float3 z_axis = qzdir(orient) * scl.z;
-    
-    return linalg::aliases::float4x4{
-        {x_axis.x, x_axis.y, x_axis.z, 0},
-        {y_axis.x, y_axis.y, y_axis.z, 0},
-        {z_axis.x, z_axis.y, z_axis.z, 0},
-        {pos.x, pos.y, pos.z, 1}
-    };
+    // The C types are read in place as minalg types, and the minalg matrix as a linalg one
+    const tinygizmo::rigid_transform t(tinygizmo::as_gizmo(orientation), tinygizmo::as_gizmo(position), tinygizmo::as_gizmo(scale));
+    return tinygizmo::math_cast<linalg::aliases::float4x4>(t.matrix());
 }
 
 std::unique_ptr<Window> win;
@@ -358,10 +345,10 @@ int main(int argc, char* argv[])
         gizmo_state.cam.near_clip = cam.near_clip;
         gizmo_state.cam.far_clip = cam.far_clip;
         gizmo_state.cam.yfov = cam.yfov;
-        gizmo_state.cam.position = {cam.position.x, cam.position.y, cam.position.z};
-        gizmo_state.cam.orientation = {cameraOrientation.x, cameraOrientation.y, cameraOrientation.z, cameraOrientation.w};
-        gizmo_state.ray_origin = {cam.position.x, cam.position.y, cam.position.z};
-        gizmo_state.ray_direction = {rayDir.x, rayDir.y, rayDir.z};
+        gizmo_state.cam.position = tinygizmo::math_cast<TG_Float3>(cam.position);
+        gizmo_state.cam.orientation = tinygizmo::math_cast<TG_Float4>(cameraOrientation);
+        gizmo_state.ray_origin = tinygizmo::math_cast<TG_Float3>(cam.position);
+        gizmo_state.ray_direction = tinygizmo::math_cast<TG_Float3>(rayDir);
         //gizmo_state.screenspace_scale = 80.f; // optional flag to draw the gizmos at a constant screen-space scale
 
         // Update callback data for this frame
@@ -133,13 +133,11 @@ void draw_lit_mesh(GlShader & shader, GlMesh & mesh, const linalg::aliases::floa
 
 void upload_mesh(const geometry_mesh & cpu, GlMesh & gpu)
 {
-    const auto & verts = reinterpret_cast<const std::vector<linalg::aliases::float3> &>(cpu.vertices);
-    const auto & tris = reinterpret_cast<const std::vector<linalg::aliases::uint3> &>(cpu.triangles);
-    gpu.set_vertices(verts, GL_DYNAMIC_DRAW);
+    gpu.set_vertices(cpu.vertices, GL_DYNAMIC_DRAW);
     gpu.set_attribute(0, 3, GL_FLOAT, GL_FALSE, sizeof(geometry_vertex), (GLvoid*) offsetof(geometry_vertex, position));
     gpu.set_attribute(1, 3, GL_FLOAT, GL_FALSE, sizeof(geometry_vertex), (GLvoid*) offsetof(geometry_vertex, normal));
     gpu.set_attribute(2, 4, GL_FLOAT, GL_FALSE, sizeof(geometry_vertex), (GLvoid*) offsetof(geometry_vertex, color));
-    gpu.set_elements(tris, GL_DYNAMIC_DRAW);
+    gpu.set_elements((GLsizei)cpu.triangles.size(), math_cast<linalg::aliases::uint3>(cpu.triangles.data()), GL_DYNAMIC_DRAW);
 }
 
 std::unique_ptr<Window> win;
@@ -262,20 +260,16 @@ int main(int argc, char * argv[])
         gizmo_state.cam.near_clip = cam.near_clip;
         gizmo_state.cam.far_clip = cam.far_clip;
         gizmo_state.cam.yfov = cam.yfov;
-        gizmo_state.cam.position = minalg::float3(cam.position.x, cam.position.y, cam.position.z);
-        gizmo_state.cam.orientation = minalg::float4(cameraOrientation.x, cameraOrientation.y, cameraOrientation.z, cameraOrientation.w);
-        gizmo_state.ray_origin = minalg::float3(cam.position.x, cam.position.y, cam.position.z);
-        gizmo_state.ray_direction = minalg::float3(rayDir.x, rayDir.y, rayDir.z);
+        gizmo_state.cam.position = as_gizmo(cam.position);
+        gizmo_state.cam.orientation = as_gizmo(cameraOrientation);
+        gizmo_state.ray_origin = as_gizmo(cam.position);
+        gizmo_state.ray_direction = as_gizmo(rayDir);
         //gizmo_state.screenspace_scale = 80.f; // optional flag to draw the gizmos at a constant screen-space scale
   
         glDisable(GL_CULL_FACE);
-        auto teapotModelMatrix_a_tmp = xform_a.matrix();
-        auto teapotModelMatrix_a = reinterpret_cast<const linalg::aliases::float4x4 &>(teapotModelMatrix_a_tmp);
-        draw_lit_mesh(litShader, teapotMesh, cam.position, cam.get_viewproj_matrix((float)windowSize.x / (float)windowSize.y), teapotModelMatrix_a);
+        draw_lit_mesh(litShader, teapotMesh, cam.position, cam.get_viewproj_matrix((float)windowSize.x / (float)windowSize.y), math_cast<linalg::aliases::float4x4>(xform_a.matrix()));
 
-        auto teapotModelMatrix_b_tmp = xform_b.matrix();
-        auto teapotModelMatrix_b = reinterpret_cast<const linalg::aliases::float4x4 &>(teapotModelMatrix_b_tmp);
-        draw_lit_mesh(litShader, teapotMesh, cam.position, cam.get_viewproj_matrix((float)windowSize.x / (float)windowSize.y), teapotModelMatrix_b);
+        draw_lit_mesh(litShader, teapotMesh, cam.position, cam.get_viewproj_matrix((float)windowSize.x / (float)windowSize.y), math_cast<linalg::aliases::float4x4>(xform_b.matrix()));
 
         glClear(GL_DEPTH_BUFFER_BIT);
 
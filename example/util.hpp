@@ -19,6 +19,13 @@
 #include "../../src/tiny-gizmo.hpp"
 #include "linalg.h"
 
+// The linalg types share the layout of their minalg counterparts, so they are handed to tinygizmo in place
+namespace tinygizmo
+{
+    template<class T, int M> struct math_type<linalg::vec<T, M>> { typedef minalg::vec<T, M> type; };
+    template<class T, int M, int N> struct math_type<linalg::mat<T, M, N>> { typedef minalg::mat<T, M, N> type; };
+}
+
 ///////////////////////////////////
 //   Windowing & App Lifecycle   //
 ///////////////////////////////////
@@ -45,13 +52,15 @@ struct camera
     linalg::aliases::float4x4 get_viewproj_matrix(const float aspectRatio) const { return mul(get_projection_matrix(aspectRatio), get_view_matrix()); }
 };
 
-// Returns a world-space ray through the given pixel, originating at the camera
+// Returns a world-space ray through the given pixel, originating at the camera. The view matrix is rigid, so the camera pose is
+// its rigid inverse and the pixel is unprojected through that pose, rather than by inverting the view-projection matrix.
 ray get_ray_from_pixel(const linalg::aliases::float2 & pixel, const rect & viewport, const camera & cam)
 {
     const float x = 2 * (pixel.x - viewport.x0) / viewport.width() - 1, y = 1 - 2 * (pixel.y - viewport.y0) / viewport.height();
-    const linalg::aliases::float4x4 inv_view_proj = inverse(cam.get_viewproj_matrix(viewport.aspect_ratio()));
-    const linalg::aliases::float4 p0 = mul(inv_view_proj, linalg::aliases::float4(x, y, -1, 1)), p1 = mul(inv_view_proj, linalg::aliases::float4(x, y, +1, 1));
-    return{ cam.position, p1.xyz()*p0.w - p0.xyz()*p1.w };
+    const float tan_half_fov = std::tan(cam.yfov / 2);
+    const minalg::float4x4 pose = minalg::inverse_rigid(tinygizmo::as_gizmo(cam.get_view_matrix()));
+    const minalg::float3 direction = mul(pose, minalg::float4(x * tan_half_fov * viewport.aspect_ratio(), y * tan_half_fov, -1, 0)).xyz();
+    return{ tinygizmo::math_cast<linalg::aliases::float3>(pose.w.xyz()), tinygizmo::math_cast<linalg::aliases::float3>(normalize(direction)) };
 }
 
 class Window
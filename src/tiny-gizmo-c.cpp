@@ -1,5 +1,5 @@
-#include "tiny-gizmo-c.h"
 #include "tiny-gizmo.hpp"
+#include "tiny-gizmo-c.h"
 
 #include <string>
 #include <memory>
@@ -28,41 +28,11 @@ struct TG_GizmoContext_t {
 };
 
 /**
- * Helper conversion functions
+ * Helper conversion functions. The vector, camera and mesh types share the layout of their
+ * tinygizmo counterparts and are adapted in place with tinygizmo::as_gizmo() and math_cast<>().
  */
-inline minalg::float2 convert(const TG_Float2& f) {
-    return minalg::float2{f.x, f.y};
-}
-
-inline minalg::float3 convert(const TG_Float3& f) {
-    return minalg::float3{f.x, f.y, f.z};
-}
-
-inline minalg::float4 convert(const TG_Float4& f) {
-    return minalg::float4{f.x, f.y, f.z, f.w};
-}
-
-inline TG_Float2 convert(const minalg::float2& f) {
-    return TG_Float2{f.x, f.y};
-}
-
-inline TG_Float3 convert(const minalg::float3& f) {
-    return TG_Float3{f.x, f.y, f.z};
-}
-
-inline TG_Float4 convert(const minalg::float4& f) {
-    return TG_Float4{f.x, f.y, f.z, f.w};
-}
-
-inline tinygizmo::camera_parameters convert(const TG_CameraParameters& c) {
-    tinygizmo::camera_parameters params;
-    params.yfov = c.yfov;
-    params.near_clip = c.near_clip;
-    params.far_clip = c.far_clip;
-    params.position = convert(c.position);
-    params.orientation = convert(c.orientation);
-    return params;
-}
+using tinygizmo::as_gizmo;
+using tinygizmo::math_cast;
 
 inline tinygizmo::gizmo_application_state convert(const TG_GizmoApplicationState& s) {
     tinygizmo::gizmo_application_state state;
@@ -76,10 +46,10 @@ inline tinygizmo::gizmo_application_state convert(const TG_GizmoApplicationState
     state.snap_translation = s.snap_translation;
     state.snap_scale = s.snap_scale;
     state.snap_rotation = s.snap_rotation;
-    state.viewport_size = convert(s.viewport_size);
-    state.ray_origin = convert(s.ray_origin);
-    state.ray_direction = convert(s.ray_direction);
-    state.cam = convert(s.cam);
+    state.viewport_size = as_gizmo(s.viewport_size);
+    state.ray_origin = as_gizmo(s.ray_origin);
+    state.ray_direction = as_gizmo(s.ray_direction);
+    state.cam = as_gizmo(s.cam);
     return state;
 }
 
@@ -151,13 +121,13 @@ TG_RigidTransform TG_CreateRigidTransformWithParams(const TG_Float4* orientation
                                                    const TG_Float3* scale) {
     TG_RigidTransform transform = new TG_RigidTransform_t();
     if (orientation) {
-        transform->transform.orientation = convert(*orientation);
+        transform->transform.orientation = as_gizmo(*orientation);
     }
     if (position) {
-        transform->transform.position = convert(*position);
+        transform->transform.position = as_gizmo(*position);
     }
     if (scale) {
-        transform->transform.scale = convert(*scale);
+        transform->transform.scale = as_gizmo(*scale);
     }
     return transform;
 }
@@ -168,27 +138,27 @@ void TG_DestroyRigidTransform(TG_RigidTransform transform) {
 
 // Rigid transform getters/setters
 void TG_GetRigidTransformPosition(TG_RigidTransform transform, TG_Float3* position) {
-    *position = convert(transform->transform.position);
+    *position = math_cast<TG_Float3>(transform->transform.position);
 }
 
 void TG_SetRigidTransformPosition(TG_RigidTransform transform, const TG_Float3* position) {
-    transform->transform.position = convert(*position);
+    transform->transform.position = as_gizmo(*position);
 }
 
 void TG_GetRigidTransformOrientation(TG_RigidTransform transform, TG_Float4* orientation) {
-    *orientation = convert(transform->transform.orientation);
+    *orientation = math_cast<TG_Float4>(transform->transform.orientation);
 }
 
 void TG_SetRigidTransformOrientation(TG_RigidTransform transform, const TG_Float4* orientation) {
-    transform->transform.orientation = convert(*orientation);
+    transform->transform.orientation = as_gizmo(*orientation);
 }
 
 void TG_GetRigidTransformScale(TG_RigidTransform transform, TG_Float3* scale) {
-    *scale = convert(transform->transform.scale);
+    *scale = math_cast<TG_Float3>(transform->transform.scale);
 }
 
 void TG_SetRigidTransformScale(TG_RigidTransform transform, const TG_Float3* scale) {
-    transform->transform.scale = convert(*scale);
+    transform->transform.scale = as_gizmo(*scale);
 }
 
 void TG_SetRigidTransformUniformScale(TG_RigidTransform transform, float scale) {
@@ -213,24 +183,14 @@ TG_GeometryVertex* TG_GetGeometryMeshVertices(TG_GeometryMesh mesh) {
     if (mesh->mesh.vertices.empty()) {
         return nullptr;
     }
-    
-    // Assuming that TG_GeometryVertex has the same memory layout as tinygizmo::geometry_vertex
-    // This is a bit dangerous, but necessary for an efficient implementation
-    static_assert(sizeof(TG_GeometryVertex) == sizeof(tinygizmo::geometry_vertex),
-                  "TG_GeometryVertex must have the same size as tinygizmo::geometry_vertex");
-                  
-    return reinterpret_cast<TG_GeometryVertex*>(mesh->mesh.vertices.data());
+
+    return math_cast<TG_GeometryVertex>(mesh->mesh.vertices.data());
 }
 
 TG_UInt3* TG_GetGeometryMeshTriangles(TG_GeometryMesh mesh) {
     if (mesh->mesh.triangles.empty()) {
         return nullptr;
     }
-    
-    // Assuming that TG_UInt3 has the same memory layout as minalg::uint3
-    // This is a bit dangerous, but necessary for an efficient implementation
-    static_assert(sizeof(TG_UInt3) == sizeof(minalg::uint3),
-                  "TG_UInt3 must have the same size as minalg::uint3");
-                  
-    return reinterpret_cast<TG_UInt3*>(mesh->mesh.triangles.data());
+
+    return math_cast<TG_UInt3>(mesh->mesh.triangles.data());
 }
\ No newline at end of file
@@ -63,6 +63,8 @@
          float yfov, near_clip, far_clip;
          TG_Float3 position;
          TG_Float4 orientation;
+         bool orthographic;        // If true, the projection is parallel and yfov is unused
+         float ortho_height;       // World-space height of the view volume of an orthographic camera
      } TG_CameraParameters;
  
      /**
@@ -153,4 +155,19 @@
  }  // extern "C"
  #endif
  
+ /**
+  * When tiny-gizmo.hpp is included first, C++ code can pass the C types to
+  * tinygizmo in place with tinygizmo::as_gizmo() and tinygizmo::math_cast<>()
+  */
+ #if defined(__cplusplus) && defined(tinygizmo_hpp)
+ namespace tinygizmo {
+     template<> struct math_type<TG_Float2> { typedef minalg::float2 type; };
+     template<> struct math_type<TG_Float3> { typedef minalg::float3 type; };
+     template<> struct math_type<TG_Float4> { typedef minalg::float4 type; };
+     template<> struct math_type<TG_UInt3> { typedef minalg::uint3 type; };
+     template<> struct math_type<TG_CameraParameters> { typedef camera_parameters type; };
+     template<> struct math_type<TG_GeometryVertex> { typedef geometry_vertex type; };
+ }
+ #endif
+ 
  #endif  // TINYGIZMO_C_H
\ No newline at end of file
@@ -6,11 +6,26 @@
 #include <assert.h>
 #include <memory>       
 #include <vector>
+#include <algorithm>
 #include <iostream>
 #include <functional>
 #include <map>
 #include <string>
 #include <chrono>
+#include <iterator>
+
+// The SSE2 and AVX kernels are compiled with per-function target attributes and only selected at runtime, so that a binary built
+// for the baseline instruction set still uses them on CPUs that support them
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define TINYGIZMO_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define TINYGIZMO_TARGET(isa)
+    #else
+        #define TINYGIZMO_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#endif
 
 using namespace minalg;
 using namespace tinygizmo;
@@ -22,6 +37,7 @@ using namespace tinygizmo;
 static const float4x4 Identity4x4 = { { 1, 0, 0, 0 },{ 0, 1, 0, 0 },{ 0, 0, 1, 0 },{ 0, 0, 0, 1 } };
 static const float3x3 Identity3x3 = { { 1, 0, 0 },{ 0, 1, 0 },{ 0, 0, 1 } };
 static const float tau = 6.28318530718f;
+static const uint32_t max_chunk_vertices = 65536; // Largest chunk passed to `render_chunk`, so that 16-bit indices suffice
 
 void flush_to_zero(float3 & f)
 {
@@ -46,6 +62,54 @@ uint32_t hash_fnv1a(const std::string & str)
     return result;
 }
 
+// Polynomial approximations of the trigonometric functions used per frame, enabled with TINYGIZMO_FAST_TRIG. The maximum absolute
+// error is 2.1e-7 for fast_sin/fast_cos over |x| < 8192 and 4.4e-7 for fast_acos on [-1,1]; fast_tan has a maximum relative error
+// of 1.6e-6 over |x| < 1.5. Arguments are reduced by multiples of pi with a three-part constant, sines and cosines use Taylor
+// polynomials of degree 11 and 12 on [-pi/2,pi/2], and fast_acos uses Abramowitz and Stegun 4.4.46. fast_sincos has no branches
+// so that compilers can vectorize it over the slices of generated geometry.
+static const float pi_a = 3.140625f, pi_b = 9.67502593994140625e-4f, pi_c = 1.509957990978376432e-7f; // Sums to pi; k*pi_a and k*pi_b are exact
+
+inline float sin_poly(float r) { const float r2 = r * r; return r * (1 + r2 * (-1.f / 6 + r2 * (1.f / 120 + r2 * (-1.f / 5040 + r2 * (1.f / 362880 + r2 * (-1.f / 39916800)))))); }
+inline float cos_poly(float r) { const float r2 = r * r; return 1 + r2 * (-1.f / 2 + r2 * (1.f / 24 + r2 * (-1.f / 720 + r2 * (1.f / 40320 + r2 * (-1.f / 3628800 + r2 * (1.f / 479001600)))))); }
+
+void fast_sincos(const float * angles, float * sines, float * cosines, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float k = std::floor(angles[i] * 0.318309886f + 0.5f);
+        const float r = ((angles[i] - k * pi_a) - k * pi_b) - k * pi_c;
+        const float sign = 1 - 2 * (k - 2 * std::floor(k * 0.5f)); // (-1)^k
+        sines[i] = sign * sin_poly(r);
+        cosines[i] = sign * cos_poly(r);
+    }
+}
+
+float fast_sin(float x) { float s, c; fast_sincos(&x, &s, &c, 1); return s; }
+float fast_cos(float x) { float s, c; fast_sincos(&x, &s, &c, 1); return c; }
+float fast_tan(float x) { float s, c; fast_sincos(&x, &s, &c, 1); return s / c; }
+
+float fast_acos(float x)
+{
+    const float a = std::min(std::abs(x), 1.f);
+    const float p = 1.5707963050f + a * (-0.2145988016f + a * (0.0889789874f + a * (-0.0501743046f + a * (0.0308918810f + a * (-0.0170881256f + a * (0.0066700901f + a * -0.0012624911f))))));
+    const float r = std::sqrt(1 - a) * p;
+    return x < 0 ? ((pi_a - r) + pi_b) + pi_c : r;
+}
+
+#if defined(TINYGIZMO_FAST_TRIG)
+inline float trig_sin(float x) { return fast_sin(x); }
+inline float trig_cos(float x) { return fast_cos(x); }
+inline float trig_tan(float x) { return fast_tan(x); }
+inline float trig_acos(float x) { return fast_acos(x); }
+inline void trig_sincos(const float * angles, float * sines, float * cosines, size_t count) { fast_sincos(angles, sines, cosines, count); }
+#else
+inline float trig_sin(float x) { return std::sin(x); }
+inline float trig_cos(float x) { return std::cos(x); }
+inline float trig_tan(float x) { return std::tan(x); }
+inline float trig_acos(float x) { return std::acos(x); }
+inline void trig_sincos(const float * angles, float * sines, float * cosines, size_t count) { for (size_t i = 0; i < count; ++i) { sines[i] = std::sin(angles[i]); cosines[i] = std::cos(angles[i]); } }
+#endif
+
 float3 snap(const float3 & value, const float snap)
 {
     if (snap > 0.0f) return float3(floor(value / snap) * snap);
@@ -54,28 +118,55 @@ float3 snap(const float3 & value, const float snap)
 
 float4 make_rotation_quat_axis_angle(const float3 & axis, float angle)
 {
-    return{ axis * std::sin(angle / 2), std::cos(angle / 2) };
+    return{ axis * trig_sin(angle / 2), trig_cos(angle / 2) };
 }
 
 float4 make_rotation_quat_between_vectors_snapped(const float3 & from, const float3 & to, const float angle)
 {
     auto a = normalize(from);
     auto b = normalize(to);
-    auto snappedAcos = std::floor(std::acos(dot(a, b)) / angle) * angle;
+    auto snappedAcos = std::floor(std::acos(dot(a, b)) / angle) * angle; // Kept exact, so that approximations never move a snap boundary
     return make_rotation_quat_axis_angle(normalize(cross(a, b)), snappedAcos);
 }
 
 template<typename T> T clamp(const T & val, const T & min, const T & max) { return std::min(std::max(val, min), max); }
 
-struct gizmo_mesh_component { geometry_mesh mesh; float4 base_color, highlight_color; };
-struct gizmo_renderable { geometry_mesh mesh; float4 color; };
+static const int lod_count = 3;
+typedef std::array<geometry_mesh, lod_count> geometry_lods;
+typedef std::array<geometry_lines, lod_count> line_lods;
+
+struct gizmo_mesh_component { geometry_lods mesh; float4 base_color, highlight_color; };
+struct gizmo_renderable { geometry_mesh mesh; geometry_lines lines; float4 color; interact component; }; // Either geometry is empty if no output consumes it
 
 struct ray { float3 origin, direction; };
 ray transform(const rigid_transform & p, const ray & r) { return{ p.transform_point(r.origin), p.transform_vector(r.direction) }; }
-ray detransform(const rigid_transform & p, const ray & r) { return{ p.detransform_point(r.origin), p.detransform_vector(r.direction) }; }
+ray detransform(const rigid_transform_inverse & inverse, const ray & r) { return{ inverse.detransform_point(r.origin), inverse.detransform_vector(r.direction) }; }
 float3 transform_coord(const float4x4 & transform, const float3 & coord) { auto r = mul(transform, float4(coord, 1)); return (r.xyz() / r.w); }
 float3 transform_vector(const float4x4 & transform, const float3 & vector) { return mul(transform, float4(vector, 0)).xyz(); }
 void transform(const float scale, ray & r) { r.origin *= scale; r.direction *= scale; }
+
+// Cofactor matrix of the upper 3x3 of `model`: its inverse transpose, up to the (positive) determinant
+float3x3 normal_matrix(const float4x4 & model)
+{
+    const float3x3 m = { model.x.xyz(), model.y.xyz(), model.z.xyz() };
+    return determinant(m) < 0 ? -transpose(adjugate(m)) : transpose(adjugate(m));
+}
+
+// Transform a whole vertex array: positions by `transform`, dividing by w only if it is projective, and normals by the cofactor
+// matrix of `model` before renormalizing them, so that non-uniform scales keep normals perpendicular to their surfaces.
+void transform_vertices(const float4x4 & transform, const float4x4 & model, std::vector<geometry_vertex> & vertices)
+{
+    const float3x3 n = normal_matrix(model);
+    const bool affine = transform.x.w == 0 && transform.y.w == 0 && transform.z.w == 0 && transform.w.w == 1;
+    for (auto & v : vertices)
+    {
+        const float3 p = transform.x.xyz()*v.position.x + transform.y.xyz()*v.position.y + transform.z.xyz()*v.position.z + transform.w.xyz();
+        v.position = affine ? p : p / dot(float4(transform.x.w, transform.y.w, transform.z.w, transform.w.w), float4(v.position, 1));
+        const float3 nn = mul(n, v.normal);
+        const float len2 = length2(nn);
+        v.normal = len2 > 0 ? nn / std::sqrt(len2) : float3(0.f);
+    }
+}
 void detransform(const float scale, ray & r) { r.origin /= scale; r.direction /= scale; }
 
 /////////////////////////////////////////
@@ -129,6 +220,245 @@ bool intersect_ray_mesh(const ray & ray, const geometry_mesh & mesh, float * hit
     return true;
 }
 
+// Copy the geometry of `r` to the given output positions, applying its color to every vertex and offsetting indices by `base`
+void merge_renderable(const gizmo_renderable & r, geometry_vertex * vertices, uint3 * triangles, uint32_t base)
+{
+    for (auto & v : r.mesh.vertices) *vertices++ = { v.position, v.normal, r.color };
+    for (auto & f : r.mesh.triangles) *triangles++ = { base + f.x, base + f.y, base + f.z };
+}
+
+//////////////////////////////
+// Runtime-Selected Kernels //
+//////////////////////////////
+
+// The SIMD kernels evaluate the same expressions in the same order as the scalar ones above, so that every tier produces
+// bit-identical geometry and hits
+#if defined(TINYGIZMO_X86)
+
+static_assert(sizeof(geometry_vertex) == 10 * sizeof(float) && sizeof(uint3) == 3 * sizeof(uint32_t), "kernels assume tightly packed vertices");
+
+TINYGIZMO_TARGET("sse2") inline __m128 gather_sse2(const geometry_vertex * v, const uint3 * t, int corner, int axis)
+{
+    return _mm_setr_ps(v[t[0][corner]].position[axis], v[t[1][corner]].position[axis], v[t[2][corner]].position[axis], v[t[3][corner]].position[axis]);
+}
+
+// Tests four triangles at a time; comparisons are negated where the scalar code rejects, so that NaNs are handled identically
+TINYGIZMO_TARGET("sse2") bool intersect_ray_mesh_sse2(const ray & r, const geometry_mesh & mesh, float * hit_t)
+{
+    const geometry_vertex * vertices = mesh.vertices.data();
+    const uint3 * tris = mesh.triangles.data();
+    const size_t count = mesh.triangles.size(), wide = count & ~size_t(3);
+    const __m128 ox = _mm_set1_ps(r.origin.x), oy = _mm_set1_ps(r.origin.y), oz = _mm_set1_ps(r.origin.z);
+    const __m128 dx = _mm_set1_ps(r.direction.x), dy = _mm_set1_ps(r.direction.y), dz = _mm_set1_ps(r.direction.z);
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1);
+    __m128 best = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    for (size_t i = 0; i < wide; i += 4)
+    {
+        const __m128 v0x = gather_sse2(vertices, tris + i, 0, 0), v0y = gather_sse2(vertices, tris + i, 0, 1), v0z = gather_sse2(vertices, tris + i, 0, 2);
+        const __m128 e1x = _mm_sub_ps(gather_sse2(vertices, tris + i, 1, 0), v0x), e1y = _mm_sub_ps(gather_sse2(vertices, tris + i, 1, 1), v0y), e1z = _mm_sub_ps(gather_sse2(vertices, tris + i, 1, 2), v0z);
+        const __m128 e2x = _mm_sub_ps(gather_sse2(vertices, tris + i, 2, 0), v0x), e2y = _mm_sub_ps(gather_sse2(vertices, tris + i, 2, 1), v0y), e2z = _mm_sub_ps(gather_sse2(vertices, tris + i, 2, 2), v0z);
+        const __m128 hx = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y)), hy = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z)), hz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+        const __m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, hx), _mm_mul_ps(e1y, hy)), _mm_mul_ps(e1z, hz));
+        const __m128 f = _mm_div_ps(one, a);
+        const __m128 sx = _mm_sub_ps(ox, v0x), sy = _mm_sub_ps(oy, v0y), sz = _mm_sub_ps(oz, v0z);
+        const __m128 u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, hx), _mm_mul_ps(sy, hy)), _mm_mul_ps(sz, hz)));
+        const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y)), qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z)), qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+        const __m128 v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)));
+        const __m128 t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)));
+        __m128 hit = _mm_and_ps(_mm_cmpneq_ps(a, zero), _mm_and_ps(_mm_cmpnlt_ps(u, zero), _mm_cmpngt_ps(u, one)));
+        hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpnlt_ps(v, zero), _mm_cmpngt_ps(_mm_add_ps(u, v), one)));
+        hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpnlt_ps(t, zero), _mm_cmplt_ps(t, best)));
+        best = _mm_or_ps(_mm_and_ps(hit, t), _mm_andnot_ps(hit, best));
+    }
+
+    float lanes[4], t;
+    _mm_storeu_ps(lanes, best);
+    float best_t = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+    for (size_t i = wide; i < count; ++i)
+    {
+        if (intersect_ray_triangle(r, vertices[tris[i][0]].position, vertices[tris[i][1]].position, vertices[tris[i][2]].position, &t) && t < best_t) best_t = t;
+    }
+    if (!(best_t < std::numeric_limits<float>::infinity())) return false;
+    if (hit_t) *hit_t = best_t;
+    return true;
+}
+
+TINYGIZMO_TARGET("avx") inline __m256 gather_avx(const geometry_vertex * v, const uint3 * t, int corner, int axis)
+{
+    return _mm256_setr_ps(v[t[0][corner]].position[axis], v[t[1][corner]].position[axis], v[t[2][corner]].position[axis], v[t[3][corner]].position[axis],
+        v[t[4][corner]].position[axis], v[t[5][corner]].position[axis], v[t[6][corner]].position[axis], v[t[7][corner]].position[axis]);
+}
+
+// As above, eight triangles at a time
+TINYGIZMO_TARGET("avx") bool intersect_ray_mesh_avx(const ray & r, const geometry_mesh & mesh, float * hit_t)
+{
+    const geometry_vertex * vertices = mesh.vertices.data();
+    const uint3 * tris = mesh.triangles.data();
+    const size_t count = mesh.triangles.size(), wide = count & ~size_t(7);
+    const __m256 ox = _mm256_set1_ps(r.origin.x), oy = _mm256_set1_ps(r.origin.y), oz = _mm256_set1_ps(r.origin.z);
+    const __m256 dx = _mm256_set1_ps(r.direction.x), dy = _mm256_set1_ps(r.direction.y), dz = _mm256_set1_ps(r.direction.z);
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1);
+    __m256 best = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    for (size_t i = 0; i < wide; i += 8)
+    {
+        const __m256 v0x = gather_avx(vertices, tris + i, 0, 0), v0y = gather_avx(vertices, tris + i, 0, 1), v0z = gather_avx(vertices, tris + i, 0, 2);
+        const __m256 e1x = _mm256_sub_ps(gather_avx(vertices, tris + i, 1, 0), v0x), e1y = _mm256_sub_ps(gather_avx(vertices, tris + i, 1, 1), v0y), e1z = _mm256_sub_ps(gather_avx(vertices, tris + i, 1, 2), v0z);
+        const __m256 e2x = _mm256_sub_ps(gather_avx(vertices, tris + i, 2, 0), v0x), e2y = _mm256_sub_ps(gather_avx(vertices, tris + i, 2, 1), v0y), e2z = _mm256_sub_ps(gather_avx(vertices, tris + i, 2, 2), v0z);
+        const __m256 hx = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y)), hy = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z)), hz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+        const __m256 a = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, hx), _mm256_mul_ps(e1y, hy)), _mm256_mul_ps(e1z, hz));
+        const __m256 f = _mm256_div_ps(one, a);
+        const __m256 sx = _mm256_sub_ps(ox, v0x), sy = _mm256_sub_ps(oy, v0y), sz = _mm256_sub_ps(oz, v0z);
+        const __m256 u = _mm256_mul_ps(f, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, hx), _mm256_mul_ps(sy, hy)), _mm256_mul_ps(sz, hz)));
+        const __m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(sz, e1y)), qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(sx, e1z)), qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(sy, e1x));
+        const __m256 v = _mm256_mul_ps(f, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)));
+        const __m256 t = _mm256_mul_ps(f, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)));
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(a, zero, _CMP_NEQ_UQ), _mm256_and_ps(_mm256_cmp_ps(u, zero, _CMP_NLT_UQ), _mm256_cmp_ps(u, one, _CMP_NGT_UQ)));
+        hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(v, zero, _CMP_NLT_UQ), _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_NGT_UQ)));
+        hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(t, zero, _CMP_NLT_UQ), _mm256_cmp_ps(t, best, _CMP_LT_OQ)));
+        best = _mm256_blendv_ps(best, t, hit);
+    }
+
+    float lanes[8], t;
+    _mm256_storeu_ps(lanes, best);
+    float best_t = *std::min_element(lanes, lanes + 8);
+    for (size_t i = wide; i < count; ++i)
+    {
+        if (intersect_ray_triangle(r, vertices[tris[i][0]].position, vertices[tris[i][1]].position, vertices[tris[i][2]].position, &t) && t < best_t) best_t = t;
+    }
+    if (!(best_t < std::numeric_limits<float>::infinity())) return false;
+    if (hit_t) *hit_t = best_t;
+    return true;
+}
+
+TINYGIZMO_TARGET("sse2") void transform_vertices_sse2(const float4x4 & transform, const float4x4 & model, std::vector<geometry_vertex> & vertices)
+{
+    const float3x3 n = normal_matrix(model);
+    const bool affine = transform.x.w == 0 && transform.y.w == 0 && transform.z.w == 0 && transform.w.w == 1;
+    const __m128 t0 = _mm_loadu_ps(&transform.x.x), t1 = _mm_loadu_ps(&transform.y.x), t2 = _mm_loadu_ps(&transform.z.x), t3 = _mm_loadu_ps(&transform.w.x);
+    const __m128 n0 = _mm_setr_ps(n.x.x, n.x.y, n.x.z, 0), n1 = _mm_setr_ps(n.y.x, n.y.y, n.y.z, 0), n2 = _mm_setr_ps(n.z.x, n.z.y, n.z.z, 0);
+    float out[8];
+    for (auto & v : vertices)
+    {
+        __m128 p = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(t0, _mm_set1_ps(v.position.x)), _mm_mul_ps(t1, _mm_set1_ps(v.position.y))), _mm_mul_ps(t2, _mm_set1_ps(v.position.z))), t3);
+        if (!affine) p = _mm_div_ps(p, _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3)));
+        _mm_storeu_ps(out, p);
+        _mm_storeu_ps(out + 4, _mm_add_ps(_mm_add_ps(_mm_mul_ps(n0, _mm_set1_ps(v.normal.x)), _mm_mul_ps(n1, _mm_set1_ps(v.normal.y))), _mm_mul_ps(n2, _mm_set1_ps(v.normal.z))));
+        const float3 nn = { out[4], out[5], out[6] };
+        const float len2 = length2(nn);
+        v.position = { out[0], out[1], out[2] };
+        v.normal = len2 > 0 ? nn / std::sqrt(len2) : float3(0.f);
+    }
+}
+
+TINYGIZMO_TARGET("avx") inline __m256 broadcast_avx(const float * p) { const __m128 v = _mm_loadu_ps(p); return _mm256_insertf128_ps(_mm256_castps128_ps256(v), v, 1); }
+
+// As above, two vertices at a time. An odd last vertex is paired with itself.
+TINYGIZMO_TARGET("avx") void transform_vertices_avx(const float4x4 & transform, const float4x4 & model, std::vector<geometry_vertex> & vertices)
+{
+    const float3x3 n = normal_matrix(model);
+    const bool affine = transform.x.w == 0 && transform.y.w == 0 && transform.z.w == 0 && transform.w.w == 1;
+    const __m256 t0 = broadcast_avx(&transform.x.x), t1 = broadcast_avx(&transform.y.x), t2 = broadcast_avx(&transform.z.x), t3 = broadcast_avx(&transform.w.x);
+    const __m256 n0 = _mm256_setr_ps(n.x.x, n.x.y, n.x.z, 0, n.x.x, n.x.y, n.x.z, 0), n1 = _mm256_setr_ps(n.y.x, n.y.y, n.y.z, 0, n.y.x, n.y.y, n.y.z, 0), n2 = _mm256_setr_ps(n.z.x, n.z.y, n.z.z, 0, n.z.x, n.z.y, n.z.z, 0);
+    float p[8], nn[8];
+    for (size_t i = 0; i < vertices.size(); i += 2)
+    {
+        geometry_vertex & a = vertices[i], & b = vertices[std::min(i + 1, vertices.size() - 1)];
+        const __m256 px = _mm256_setr_ps(a.position.x, a.position.x, a.position.x, a.position.x, b.position.x, b.position.x, b.position.x, b.position.x);
+        const __m256 py = _mm256_setr_ps(a.position.y, a.position.y, a.position.y, a.position.y, b.position.y, b.position.y, b.position.y, b.position.y);
+        const __m256 pz = _mm256_setr_ps(a.position.z, a.position.z, a.position.z, a.position.z, b.position.z, b.position.z, b.position.z, b.position.z);
+        const __m256 nx = _mm256_setr_ps(a.normal.x, a.normal.x, a.normal.x, a.normal.x, b.normal.x, b.normal.x, b.normal.x, b.normal.x);
+        const __m256 ny = _mm256_setr_ps(a.normal.y, a.normal.y, a.normal.y, a.normal.y, b.normal.y, b.normal.y, b.normal.y, b.normal.y);
+        const __m256 nz = _mm256_setr_ps(a.normal.z, a.normal.z, a.normal.z, a.normal.z, b.normal.z, b.normal.z, b.normal.z, b.normal.z);
+        __m256 pp = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(t0, px), _mm256_mul_ps(t1, py)), _mm256_mul_ps(t2, pz)), t3);
+        if (!affine) pp = _mm256_div_ps(pp, _mm256_permute_ps(pp, _MM_SHUFFLE(3, 3, 3, 3)));
+        _mm256_storeu_ps(p, pp);
+        _mm256_storeu_ps(nn, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(n0, nx), _mm256_mul_ps(n1, ny)), _mm256_mul_ps(n2, nz)));
+        for (int k = 1; k >= 0; --k)
+        {
+            geometry_vertex & out = k ? b : a;
+            const float3 normal = { nn[k * 4], nn[k * 4 + 1], nn[k * 4 + 2] };
+            const float len2 = length2(normal);
+            out.position = { p[k * 4], p[k * 4 + 1], p[k * 4 + 2] };
+            out.normal = len2 > 0 ? normal / std::sqrt(len2) : float3(0.f);
+        }
+    }
+}
+
+TINYGIZMO_TARGET("sse2") void merge_indices_sse2(const std::vector<uint3> & in, uint3 * triangles, uint32_t base)
+{
+    const uint32_t * src = in.empty() ? nullptr : &in[0].x;
+    uint32_t * dst = &triangles->x;
+    const size_t count = in.size() * 3, wide = count & ~size_t(3);
+    const __m128i offset = _mm_set1_epi32((int) base);
+    for (size_t i = 0; i < wide; i += 4) _mm_storeu_si128((__m128i *) (dst + i), _mm_add_epi32(_mm_loadu_si128((const __m128i *) (src + i)), offset));
+    for (size_t i = wide; i < count; ++i) dst[i] = src[i] + base;
+}
+
+// Each vertex is copied as two overlapping four-float stores, the second of which is then overwritten by the color
+TINYGIZMO_TARGET("sse2") void merge_renderable_sse2(const gizmo_renderable & r, geometry_vertex * vertices, uint3 * triangles, uint32_t base)
+{
+    const __m128 color = _mm_loadu_ps(&r.color.x);
+    for (auto & v : r.mesh.vertices)
+    {
+        const float * src = reinterpret_cast<const float *>(&v);
+        float * dst = reinterpret_cast<float *>(vertices++);
+        _mm_storeu_ps(dst, _mm_loadu_ps(src));
+        _mm_storeu_ps(dst + 4, _mm_loadu_ps(src + 4));
+        _mm_storeu_ps(dst + 6, color);
+    }
+    merge_indices_sse2(r.mesh.triangles, triangles, base);
+}
+
+// AVX has no 256 bit integer arithmetic, so the indices go through the SSE2 path
+TINYGIZMO_TARGET("avx") void merge_renderable_avx(const gizmo_renderable & r, geometry_vertex * vertices, uint3 * triangles, uint32_t base)
+{
+    const __m128 color = _mm_loadu_ps(&r.color.x);
+    for (auto & v : r.mesh.vertices)
+    {
+        float * dst = reinterpret_cast<float *>(vertices++);
+        _mm256_storeu_ps(dst, _mm256_loadu_ps(reinterpret_cast<const float *>(&v)));
+        _mm_storeu_ps(dst + 6, color);
+    }
+    merge_indices_sse2(r.mesh.triangles, triangles, base);
+}
+
+#endif // TINYGIZMO_X86
+
+cpu_tier tinygizmo::detect_cpu_tier()
+{
+#if defined(TINYGIZMO_X86) && defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool avx = (info[2] & (1 << 28)) && (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6; // Also requires the OS to save ymm registers
+    return avx ? cpu_tier::avx : sse2 ? cpu_tier::sse2 : cpu_tier::scalar;
+#elif defined(TINYGIZMO_X86)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") ? cpu_tier::avx : __builtin_cpu_supports("sse2") ? cpu_tier::sse2 : cpu_tier::scalar;
+#else
+    return cpu_tier::scalar;
+#endif
+}
+
+// Function pointers to the hot kernels, selected once per context
+struct gizmo_kernels
+{
+    cpu_tier tier;
+    bool (*intersect_ray_mesh)(const ray & r, const geometry_mesh & mesh, float * hit_t);
+    void (*transform_vertices)(const float4x4 & transform, const float4x4 & model, std::vector<geometry_vertex> & vertices);
+    void (*merge_renderable)(const gizmo_renderable & r, geometry_vertex * vertices, uint3 * triangles, uint32_t base);
+};
+
+gizmo_kernels select_kernels(const cpu_tier max_tier)
+{
+    const cpu_tier tier = std::min(detect_cpu_tier(), max_tier);
+#if defined(TINYGIZMO_X86)
+    if (tier == cpu_tier::avx) return{ tier, intersect_ray_mesh_avx, transform_vertices_avx, merge_renderable_avx };
+    if (tier == cpu_tier::sse2) return{ tier, intersect_ray_mesh_sse2, transform_vertices_sse2, merge_renderable_sse2 };
+#endif
+    return{ tier, intersect_ray_mesh, transform_vertices, merge_renderable };
+}
+
 ///////////////////////////////
 // Geometry + Mesh Utilities //
 ///////////////////////////////
@@ -200,10 +530,13 @@ geometry_mesh make_cylinder_geometry(const float3 & axis, const float3 & arm1, c
     // Generated curved surface
     geometry_mesh mesh;
 
+    std::vector<float> angles(slices), sines(slices), cosines(slices);
+    for (uint32_t i = 0; i < slices; ++i) angles[i] = static_cast<float>(i) * tau / slices;
+    trig_sincos(angles.data(), sines.data(), cosines.data(), slices);
+
     for (uint32_t i = 0; i <= slices; ++i)
     {
-        const float tex_s = static_cast<float>(i) / slices, angle = (float)(i%slices) * tau / slices;
-        const float3 arm = arm1 * std::cos(angle) + arm2 * std::sin(angle);
+        const float3 arm = arm1 * cosines[i % slices] + arm2 * sines[i % slices];
         mesh.vertices.push_back({ arm, normalize(arm) });
         mesh.vertices.push_back({ arm + axis, normalize(arm) });
     }
@@ -217,8 +550,7 @@ geometry_mesh make_cylinder_geometry(const float3 & axis, const float3 & arm1, c
     uint32_t base = (uint32_t) mesh.vertices.size();
     for (uint32_t i = 0; i < slices; ++i)
     {
-        const float angle = static_cast<float>(i%slices) * tau / slices, c = std::cos(angle), s = std::sin(angle);
-        const float3 arm = arm1 * c + arm2 * s;
+        const float3 arm = arm1 * cosines[i] + arm2 * sines[i];
         mesh.vertices.push_back({ arm + axis, normalize(axis) });
         mesh.vertices.push_back({ arm, -normalize(axis) });
     }
@@ -233,16 +565,22 @@ geometry_mesh make_cylinder_geometry(const float3 & axis, const float3 & arm1, c
 geometry_mesh make_lathed_geometry(const float3 & axis, const float3 & arm1, const float3 & arm2, int slices, const std::vector<float2> & points, const float eps = 0.0f)
 {
     geometry_mesh mesh;
+    std::vector<float> angles(slices), sines(slices), cosines(slices);
+    for (int i = 0; i < slices; ++i) angles[i] = (static_cast<float>(i) * tau / slices) + (tau/8.f);
+    trig_sincos(angles.data(), sines.data(), cosines.data(), slices);
+
     for (int i = 0; i <= slices; ++i)
     {
-        const float angle = (static_cast<float>(i % slices) * tau / slices) + (tau/8.f), c = std::cos(angle), s = std::sin(angle);
-        const float3x2 mat = { axis, arm1 * c + arm2 * s };
+        const float3x2 mat = { axis, arm1 * cosines[i % slices] + arm2 * sines[i % slices] };
         for (auto & p : points) mesh.vertices.push_back({ mul(mat, p) + eps, float3(0.f) });
 
+        // Alternate the direction along the profile between slices, so that each slice starts next to where the previous one
+        // ended and reuses its vertices while they are still in the post-transform cache
         if (i > 0)
         {
-            for (uint32_t j = 1; j < (uint32_t) points.size(); ++j)
+            for (uint32_t k = 1; k < (uint32_t) points.size(); ++k)
             {
+                const uint32_t j = (i % 2) ? k : (uint32_t) points.size() - k;
                 uint32_t i0 = (i - 1)* uint32_t(points.size()) + (j - 1);
                 uint32_t i1 = (i - 0)* uint32_t(points.size()) + (j - 1);
                 uint32_t i2 = (i - 0)* uint32_t(points.size()) + (j - 0);
@@ -256,21 +594,268 @@ geometry_mesh make_lathed_geometry(const float3 & axis, const float3 & arm1, con
     return mesh;
 }
 
+// Lathed components are generated at several levels of detail, each with half the slices of the previous one
+geometry_lods make_lathed_lods(const float3 & axis, const float3 & arm1, const float3 & arm2, int slices, const std::vector<float2> & points, const float eps = 0.0f)
+{
+    geometry_lods lods;
+    for (int i = 0; i < lod_count; ++i) lods[i] = make_lathed_geometry(axis, arm1, arm2, slices >> i, points, eps);
+    return lods;
+}
+
+// Extract `count` consecutive slices of a lathed mesh generated with `slices` slices, starting at `first` and wrapping around
+geometry_mesh extract_lathed_slices(const geometry_mesh & mesh, uint32_t slices, uint32_t first, uint32_t count)
+{
+    const uint32_t points = (uint32_t) mesh.vertices.size() / (slices + 1), slice_triangles = (uint32_t) mesh.triangles.size() / slices;
+    geometry_mesh result;
+    auto append = [&](uint32_t begin, uint32_t end)
+    {
+        const uint32_t base = (uint32_t) result.vertices.size(), offset = begin * points;
+        result.vertices.insert(result.vertices.end(), mesh.vertices.begin() + offset, mesh.vertices.begin() + (end + 1) * points);
+        for (uint32_t i = begin * slice_triangles; i < end * slice_triangles; ++i)
+        {
+            const uint3 & t = mesh.triangles[i];
+            result.triangles.push_back({ t.x - offset + base, t.y - offset + base, t.z - offset + base });
+        }
+    };
+    if (first + count <= slices) append(first, first + count);
+    else { append(first, slices); append(0, first + count - slices); }
+    return result;
+}
+
+geometry_lods make_box_lods(const float3 & min_bounds, const float3 & max_bounds)
+{
+    geometry_lods lods;
+    lods.fill(make_box_geometry(min_bounds, max_bounds)); // A box has no coarser representation
+    return lods;
+}
+
+// Line equivalents of the components: a shaft with a pyramid (arrow) or cube (mace) head, the centerline of a ring and the
+// outline of a box. Heads are drawn with four edges around the axis, at the same 45 degree offset as the lathed meshes.
+void add_line_loop(geometry_lines & lines, uint32_t first, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i) lines.lines.push_back({ first + i, first + (i + 1) % count });
+}
+
+geometry_lines make_shaft_lines(const float3 & axis, const float3 & arm1, const float3 & arm2, float start, float end, float head_length, float head_radius, bool cone)
+{
+    geometry_lines lines;
+    auto vertex = [&](const float3 & p) { lines.vertices.push_back({ p, float3(0.f), float4(1.f) }); return (uint32_t) lines.vertices.size() - 1; };
+    auto head_ring = [&](float h)
+    {
+        const uint32_t first = (uint32_t) lines.vertices.size();
+        for (int i = 0; i < 4; ++i)
+        {
+            const float angle = i * tau / 4 + tau / 8;
+            vertex(axis * h + (arm1 * trig_cos(angle) + arm2 * trig_sin(angle)) * head_radius);
+        }
+        add_line_loop(lines, first, 4);
+        return first;
+    };
+
+    const uint32_t shaft = vertex(axis * start);
+    lines.lines.push_back({ shaft, vertex(axis * (end + (cone ? head_length : 0))) });
+    const uint32_t base = head_ring(end);
+    if (cone) for (uint32_t i = 0; i < 4; ++i) lines.lines.push_back({ shaft + 1, base + i });
+    else
+    {
+        const uint32_t top = head_ring(end + head_length);
+        for (uint32_t i = 0; i < 4; ++i) lines.lines.push_back({ base + i, top + i });
+    }
+    return lines;
+}
+
+// Rings have one segment per slice of their lathed mesh at each level of detail, so that they can be trimmed the same way
+geometry_lines make_ring_lines(const float3 & arm1, const float3 & arm2, int segments, float radius)
+{
+    geometry_lines lines;
+    for (int i = 0; i < segments; ++i)
+    {
+        const float angle = i * tau / segments + tau / 8;
+        lines.vertices.push_back({ (arm1 * trig_cos(angle) + arm2 * trig_sin(angle)) * radius, float3(0.f), float4(1.f) });
+    }
+    add_line_loop(lines, 0, segments);
+    return lines;
+}
+
+line_lods make_ring_line_lods(const float3 & arm1, const float3 & arm2, int segments, float radius)
+{
+    line_lods lods;
+    for (int i = 0; i < lod_count; ++i) lods[i] = make_ring_lines(arm1, arm2, segments >> i, radius);
+    return lods;
+}
+
+line_lods make_line_lods(const geometry_lines & lines)
+{
+    line_lods lods;
+    lods.fill(lines); // Only rings have coarser line representations
+    return lods;
+}
+
+// Extract `count` consecutive segments of a ring with `segments` segments as an open polyline, starting at `first` and wrapping around
+geometry_lines extract_ring_segments(const geometry_lines & ring, uint32_t segments, uint32_t first, uint32_t count)
+{
+    geometry_lines result;
+    for (uint32_t i = 0; i <= count; ++i) result.vertices.push_back(ring.vertices[(first + i) % segments]);
+    for (uint32_t i = 0; i < count; ++i) result.lines.push_back({ i, i + 1 });
+    return result;
+}
+
+// Flat boxes (the plane handles) are drawn as a single rectangle at their mid plane, other boxes as their twelve edges
+geometry_lines make_box_lines(const float3 & min_bounds, const float3 & max_bounds)
+{
+    geometry_lines lines;
+    const float3 size = max_bounds - min_bounds, center = (min_bounds + max_bounds) * 0.5f;
+    int flat = -1;
+    for (int i = 0; i < 3; ++i) if (size[i] < 0.1f * std::max(size.x, std::max(size.y, size.z))) flat = i;
+
+    if (flat >= 0)
+    {
+        const int u = (flat + 1) % 3, v = (flat + 2) % 3;
+        const float2 corners[4] = { { min_bounds[u], min_bounds[v] },{ max_bounds[u], min_bounds[v] },{ max_bounds[u], max_bounds[v] },{ min_bounds[u], max_bounds[v] } };
+        for (auto & c : corners)
+        {
+            float3 p = center; p[u] = c.x; p[v] = c.y;
+            lines.vertices.push_back({ p, float3(0.f), float4(1.f) });
+        }
+        add_line_loop(lines, 0, 4);
+        return lines;
+    }
+
+    for (uint32_t i = 0; i < 8; ++i) lines.vertices.push_back({ { (i & 1) ? max_bounds.x : min_bounds.x, (i & 2) ? max_bounds.y : min_bounds.y, (i & 4) ? max_bounds.z : min_bounds.z }, float3(0.f), float4(1.f) });
+    for (uint32_t i = 0; i < 8; ++i) for (uint32_t bit = 1; bit < 8; bit <<= 1) if (!(i & bit)) lines.lines.push_back({ i, i | bit });
+    return lines;
+}
+
+////////////////////////////
+//   Mesh Optimization    //
+////////////////////////////
+
+// Tipsify (Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"): triangles are
+// emitted in fans around a vertex, moving to the adjacent vertex that is still in the cache and has the most triangles left.
+// Small meshes generated as strips are often already better than that, in which case their triangle order is kept.
+void tinygizmo::optimize_geometry(geometry_mesh & mesh, uint32_t cache_size)
+{
+    const uint32_t numVerts = (uint32_t) mesh.vertices.size(), numTris = (uint32_t) mesh.triangles.size();
+    if (numTris == 0) return;
+
+    // Triangles adjacent to each vertex, as offsets into one array
+    std::vector<uint32_t> live(numVerts, 0), adjacency_offset(numVerts + 1, 0), adjacency(numTris * 3);
+    for (auto & t : mesh.triangles) for (int j = 0; j < 3; ++j) live[t[j]]++;
+    for (uint32_t v = 0; v < numVerts; ++v) adjacency_offset[v + 1] = adjacency_offset[v] + live[v];
+    std::vector<uint32_t> fill(adjacency_offset.begin(), adjacency_offset.end() - 1);
+    for (uint32_t i = 0; i < numTris; ++i) for (int j = 0; j < 3; ++j) adjacency[fill[mesh.triangles[i][j]]++] = i;
+
+    std::vector<uint32_t> cache_time(numVerts, 0), dead_end, candidates;
+    std::vector<bool> emitted(numTris, false);
+    std::vector<uint3> triangles;
+    triangles.reserve(numTris);
+    uint32_t time = cache_size + 1, cursor = 1;
+    int64_t fanning = 0;
+
+    while (fanning >= 0)
+    {
+        candidates.clear();
+        for (uint32_t a = adjacency_offset[fanning]; a < adjacency_offset[fanning + 1]; ++a)
+        {
+            const uint32_t t = adjacency[a];
+            if (emitted[t]) continue;
+            for (int j = 0; j < 3; ++j)
+            {
+                const uint32_t v = mesh.triangles[t][j];
+                dead_end.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                if (time - cache_time[v] > cache_size) cache_time[v] = time++;
+            }
+            triangles.push_back(mesh.triangles[t]);
+            emitted[t] = true;
+        }
+
+        // Prefer the candidate that entered the cache earliest but will still be in it after its remaining triangles are emitted
+        fanning = -1;
+        int64_t best_priority = -1;
+        for (auto v : candidates)
+        {
+            if (live[v] == 0) continue;
+            const int64_t priority = (time - cache_time[v] + 2 * live[v] <= cache_size) ? time - cache_time[v] : 0;
+            if (priority > best_priority) { best_priority = priority; fanning = v; }
+        }
+
+        // Otherwise resume from the most recently referenced vertex with triangles left, then from the next one in input order
+        while (fanning < 0 && !dead_end.empty())
+        {
+            const uint32_t v = dead_end.back();
+            dead_end.pop_back();
+            if (live[v] > 0) fanning = v;
+        }
+        while (fanning < 0 && cursor < numVerts)
+        {
+            if (live[cursor] > 0) fanning = cursor;
+            ++cursor;
+        }
+    }
+
+    const float input_acmr = compute_acmr(mesh, cache_size);
+    mesh.triangles.swap(triangles);
+    if (compute_acmr(mesh, cache_size) >= input_acmr) mesh.triangles.swap(triangles);
+
+    // Renumber the vertices in the order they are first referenced, so that vertex fetches are sequential as well
+    std::vector<uint32_t> remap(numVerts, UINT32_MAX);
+    std::vector<geometry_vertex> vertices;
+    vertices.reserve(numVerts);
+    for (auto & t : mesh.triangles) for (int j = 0; j < 3; ++j)
+    {
+        if (remap[t[j]] == UINT32_MAX) { remap[t[j]] = (uint32_t) vertices.size(); vertices.push_back(mesh.vertices[t[j]]); }
+        t[j] = remap[t[j]];
+    }
+    mesh.vertices.swap(vertices);
+}
+
+float tinygizmo::compute_acmr(const geometry_mesh & mesh, uint32_t cache_size)
+{
+    if (mesh.triangles.empty()) return 0.f;
+
+    std::vector<uint32_t> fifo(cache_size, UINT32_MAX);
+    uint32_t head = 0, misses = 0;
+    for (auto & t : mesh.triangles) for (int j = 0; j < 3; ++j)
+    {
+        if (std::find(fifo.begin(), fifo.end(), t[j]) != fifo.end()) continue;
+        fifo[head] = t[j];
+        head = (head + 1) % cache_size;
+        ++misses;
+    }
+    return (float) misses / mesh.triangles.size();
+}
+
+// Append a renderable to a mesh, with its color as a per-vertex attribute
+void append_renderable(const gizmo_kernels & k, geometry_mesh & mesh, const gizmo_renderable & m)
+{
+    const uint32_t base = (uint32_t) mesh.vertices.size();
+    const size_t first_triangle = mesh.triangles.size();
+    mesh.vertices.resize(base + m.mesh.vertices.size());
+    mesh.triangles.resize(first_triangle + m.mesh.triangles.size());
+    k.merge_renderable(m, mesh.vertices.data() + base, mesh.triangles.data() + first_triangle, base);
+}
+
+// Stable LSD radix sort of indices by 16 bit keys, in two passes of 8 bits
+struct depth_key { uint16_t key; uint32_t index; };
+void radix_sort(std::vector<depth_key> & keys, std::vector<depth_key> & scratch)
+{
+    scratch.resize(keys.size());
+    for (int shift = 0; shift < 16; shift += 8)
+    {
+        uint32_t offsets[256] = {};
+        for (auto & k : keys) offsets[(k.key >> shift) & 0xff]++;
+        for (uint32_t i = 0, sum = 0; i < 256; ++i) { const uint32_t count = offsets[i]; offsets[i] = sum; sum += count; }
+        for (auto & k : keys) scratch[offsets[(k.key >> shift) & 0xff]++] = k;
+        keys.swap(scratch);
+    }
+}
+
 //////////////////////////////////
 // Gizmo Context Implementation //
 //////////////////////////////////
 
-enum class interact
-{
-    none,
-    translate_x, translate_y, translate_z,
-    translate_yz, translate_zx, translate_xy,
-    translate_xyz,
-    rotate_x, rotate_y, rotate_z,
-    scale_x, scale_y, scale_z,
-    scale_xyz,
-};
-
 struct interaction_state
 {
     bool active{ false };                   // Flag to indicate if the gizmo is being actively manipulated
@@ -280,6 +865,49 @@ struct interaction_state
     float3 original_scale;                  // Original scale of an object being manipulated with a gizmo
     float3 click_offset;                    // Offset from position of grabbed object to coordinates of clicked point
     interact interaction_mode;              // Currently active component
+    int lod{ 0 };                           // Level of detail the gizmo was drawn and picked with in the last frame
+    uint32_t hidden{ 0 };                   // Components neither drawn nor picked this frame, as a bitmask of `interact` values
+};
+
+// World-space geometry of a single gizmo, retained across frames along with the inputs it was generated from
+struct gizmo_draw_cache
+{
+    bool valid{ false };                    // False until the geometry has been generated at least once
+    uint32_t id;                            // Hash of the gizmo name
+    float4x4 model;                         // Model matrix (transform, space and draw_scale) the geometry was generated with
+    float4x4 output;                        // Matrix the vertex positions were transformed with: the model matrix, followed by the camera for non-world output
+    std::vector<interact> components;       // Components the geometry was generated for, which also identify the mode
+    interact highlight;                     // Highlighted component the geometry was generated for
+    int lod;                                // Level of detail the geometry was generated with
+    uint32_t variant;                       // Identifies view-dependent component meshes, such as trimmed rotation rings
+    uint32_t hidden;                        // Components left out because their projection degenerated
+    bool triangles, lines;                  // Whether triangle meshes and line lists were generated, which depends on the callbacks set
+    uint32_t revision{ 0 };                 // Assigned from the context's counter whenever the renderables are regenerated
+    int selected_lod{ 0 };                  // Level of detail chosen by `select_lod(...)` for this viewport, kept for its hysteresis
+    uint64_t frame{ 0 };                    // Frame the gizmo was last emitted in; entries not emitted in the previous frame are released
+    std::vector<gizmo_renderable> renderables;
+};
+
+// Camera-facing half of a rotation ring, as a mesh and as lines
+struct trimmed_ring_geometry { geometry_mesh mesh; geometry_lines lines; };
+
+// Region of the merged output owned by one drawlist entry. Slots keep their offsets across frames so that a changed gizmo
+// only rewrites its own region; unused capacity is filled with degenerate triangles.
+struct geometry_slot { uint32_t vertex_offset, vertex_capacity, triangle_offset, triangle_capacity, revision; };
+
+// Bounding planes of a view frustum with inward unit normals. The near plane comes first, so that a sphere entirely behind it
+// is known to be behind the camera.
+struct frustum { float4 planes[6]; };
+
+// Camera constants derived once per viewport by `use_viewport(...)`, rather than by every gizmo
+struct camera_frame
+{
+    float3 forward;                         // World-space view direction of `cam`
+    bool orthographic;                      // Of `cam`, whose screen-space scale is then `ortho_height` at every depth
+    float tan_yfov;                         // Slope of the full vertical field of view, which screen-space scale is based on
+    float4x4 view_projection;               // World to clip space for `cam`, or the app's `projection * view`
+    frustum frusta[2];                      // Of `cam`, or in stereo mode of each eye, since a culled gizmo must be outside both
+    uint32_t frustum_count;
 };
 
 struct gizmo_context::gizmo_context_impl
@@ -289,9 +917,51 @@ struct gizmo_context::gizmo_context_impl
     gizmo_context_impl(gizmo_context * ctx);
 
     std::map<interact, gizmo_mesh_component> mesh_components;
-    std::vector<gizmo_renderable> drawlist;
+    std::map<uint64_t, gizmo_draw_cache> draw_cache; // Keyed by viewport and gizmo id
+    std::vector<gizmo_draw_cache *> drawlist; // Gizmos emitted for viewport 0; the other viewports use `viewport_drawlists`
+    uint32_t revisions{ 0 };                // Source of `gizmo_draw_cache::revision`, so that a revision is never reused by another entry
+    std::vector<std::pair<const gizmo_draw_cache *, uint32_t>> drawn_contents; // Drawlist and revisions of the last call to `draw()`
+    std::vector<std::pair<const gizmo_draw_cache *, uint32_t>> contents; // Drawlist and revisions of this call, swapped with the above so that neither is reallocated
+    uint64_t generation{ 0 };               // Incremented by `draw()` whenever the emitted geometry differs from the last call
+    uint64_t frame{ 0 };                    // Incremented by `update(...)`
+
+    geometry_mesh merged;                   // Interleaved output, retained and only rebuilt when the generation changes
+    uint64_t merged_generation{ 0 };
+    std::vector<gizmo_draw_cache *> merged_drawlist; // Drawlist the slot layout of `merged` was built for
+    std::vector<geometry_slot> slots;       // One slot per entry of `merged_drawlist`
+    std::vector<geometry_range> dirty_ranges; // Ranges of `merged` rewritten by the last call to `draw()`
+    geometry_streams streams;               // Structure-of-arrays output, retained to reuse its allocations across frames
+    uint64_t streams_generation{ 0 };
+    geometry_chunk chunks[2];               // Chunked output alternates between two buffers, so chunk N stays valid until the callback for N+1 returns
+    std::map<interact, gizmo_impostor> impostor_shapes; // Analytic equivalents of `mesh_components`, in gizmo units
+    geometry_mesh opaque_batch;             // Batched output, split by the alpha of each component
+    geometry_mesh transparent_batch;
+    uint64_t batches_generation{ 0 };
+    std::vector<const gizmo_renderable *> transparent; // Translucent components of the drawlist, in drawlist order
+    std::vector<uint32_t> transparent_order; // Back-to-front order `transparent_batch` was written in
+    std::vector<float> transparent_depths;
+    std::vector<depth_key> depth_keys, depth_scratch;
+    std::map<interact, line_lods> line_components; // Line equivalents of `mesh_components`, in gizmo units
+    std::map<uint32_t, trimmed_ring_geometry> trimmed_rings; // Camera-facing halves of the rotation rings, keyed by ring, level of detail and first slice
+    geometry_lines lines;                   // Line list output, retained and only rebuilt when the generation changes
+    uint64_t lines_generation{ 0 };
+    std::vector<gizmo_impostor> impostors;
+    std::vector<interact> selected_components; // Retained by `select_components(...)` for the gizmo being emitted
 
     transform_mode mode{ transform_mode::translate };
+    float4x4 output_matrix;                 // World to output space, folded into each gizmo's model matrix by `emit(...)`
+    camera_frame camera;                    // Derived from `active_state` by `use_viewport(...)`
+
+    std::vector<gizmo_viewport> viewports;  // Viewports passed to `update(...)`, or empty for the single view of `active_state`
+    gizmo_application_state input_state;    // State passed to `update(...)`, before a viewport is applied
+    uint32_t active_viewport{ 0 };          // Viewport receiving picking and dragging
+    uint32_t current_viewport{ 0 };         // Viewport the gizmo functions are currently emitting for
+    bool interactive{ true };               // False while emitting for a viewport other than the active one; no picking or dragging happens
+    std::vector<std::vector<gizmo_draw_cache *>> viewport_drawlists; // Gizmos emitted for each viewport but the first
+    std::vector<geometry_mesh> viewport_meshes; // Retained `render_viewport` output
+    std::vector<std::vector<std::pair<const gizmo_draw_cache *, uint32_t>>> viewport_contents; // Drawlist and revisions each viewport mesh was built from
+    gizmo_stats stats;
+    gizmo_kernels kernels;                  // Picking, vertex transform and merge routines for the tier chosen at construction
 
     std::map<uint32_t, interaction_state> gizmos;
 
@@ -303,7 +973,12 @@ struct gizmo_context::gizmo_context_impl
 
     // Public methods
     void update(const gizmo_application_state & state);
+    void update(const gizmo_application_state & state, const std::vector<gizmo_viewport> & viewports);
+    void use_viewport(uint32_t index);
     void draw();
+
+    void write_slot(size_t index);
+    void layout_merged();
 };
 
 gizmo_context::gizmo_context_impl::gizmo_context_impl(gizmo_context * ctx) : ctx(ctx)
@@ -311,61 +986,694 @@ gizmo_context::gizmo_context_impl::gizmo_context_impl(gizmo_context * ctx) : ctx
     std::vector<float2> arrow_points            = { { 0.25f, 0 }, { 0.25f, 0.05f },{ 1, 0.05f },{ 1, 0.10f },{ 1.2f, 0 } };
     std::vector<float2> mace_points             = { { 0.25f, 0 }, { 0.25f, 0.05f },{ 1, 0.05f },{ 1, 0.1f },{ 1.25f, 0.1f }, { 1.25f, 0 } };
     std::vector<float2> ring_points             = { { +0.025f, 1 },{ -0.025f, 1 },{ -0.025f, 1 },{ -0.025f, 1.1f },{ -0.025f, 1.1f },{ +0.025f, 1.1f },{ +0.025f, 1.1f },{ +0.025f, 1 } };
-    mesh_components[interact::translate_x]      = { make_lathed_geometry({ 1,0,0 },{ 0,1,0 },{ 0,0,1 }, 16, arrow_points), { 1,0.5f,0.5f, 1.f }, { 1,0,0, 1.f } };
-    mesh_components[interact::translate_y]      = { make_lathed_geometry({ 0,1,0 },{ 0,0,1 },{ 1,0,0 }, 16, arrow_points), { 0.5f,1,0.5f, 1.f }, { 0,1,0, 1.f } };
-    mesh_components[interact::translate_z]      = { make_lathed_geometry({ 0,0,1 },{ 1,0,0 },{ 0,1,0 }, 16, arrow_points), { 0.5f,0.5f,1, 1.f }, { 0,0,1, 1.f } };
-    mesh_components[interact::translate_yz]     = { make_box_geometry({ -0.01f,0.25,0.25 },{ 0.01f,0.75f,0.75f }), { 0.5f,1,1, 0.5f }, { 0,1,1, 0.6f } };
-    mesh_components[interact::translate_zx]     = { make_box_geometry({ 0.25,-0.01f,0.25 },{ 0.75f,0.01f,0.75f }), { 1,0.5f,1, 0.5f }, { 1,0,1, 0.6f } };
-    mesh_components[interact::translate_xy]     = { make_box_geometry({ 0.25,0.25,-0.01f },{ 0.75f,0.75f,0.01f }), { 1,1,0.5f, 0.5f }, { 1,1,0, 0.6f } };
-    mesh_components[interact::translate_xyz]    = { make_box_geometry({ -0.05f,-0.05f,-0.05f },{ 0.05f,0.05f,0.05f }),{ 0.9f, 0.9f, 0.9f, 0.25f },{ 1,1,1, 0.35f } };
-    mesh_components[interact::rotate_x]         = { make_lathed_geometry({ 1,0,0 },{ 0,1,0 },{ 0,0,1 }, 32, ring_points, 0.003f), { 1, 0.5f, 0.5f, 1.f }, { 1, 0, 0, 1.f } };
-    mesh_components[interact::rotate_y]         = { make_lathed_geometry({ 0,1,0 },{ 0,0,1 },{ 1,0,0 }, 32, ring_points, -0.003f), { 0.5f,1,0.5f, 1.f }, { 0,1,0, 1.f } };
-    mesh_components[interact::rotate_z]         = { make_lathed_geometry({ 0,0,1 },{ 1,0,0 },{ 0,1,0 }, 32, ring_points), { 0.5f,0.5f,1, 1.f }, { 0,0,1, 1.f } };
-    mesh_components[interact::scale_x]          = { make_lathed_geometry({ 1,0,0 },{ 0,1,0 },{ 0,0,1 }, 16, mace_points),{ 1,0.5f,0.5f, 1.f },{ 1,0,0, 1.f } };
-    mesh_components[interact::scale_y]          = { make_lathed_geometry({ 0,1,0 },{ 0,0,1 },{ 1,0,0 }, 16, mace_points),{ 0.5f,1,0.5f, 1.f },{ 0,1,0, 1.f } };
-    mesh_components[interact::scale_z]          = { make_lathed_geometry({ 0,0,1 },{ 1,0,0 },{ 0,1,0 }, 16, mace_points),{ 0.5f,0.5f,1, 1.f },{ 0,0,1, 1.f } };
+    mesh_components[interact::translate_x]      = { make_lathed_lods({ 1,0,0 },{ 0,1,0 },{ 0,0,1 }, 16, arrow_points), { 1,0.5f,0.5f, 1.f }, { 1,0,0, 1.f } };
+    mesh_components[interact::translate_y]      = { make_lathed_lods({ 0,1,0 },{ 0,0,1 },{ 1,0,0 }, 16, arrow_points), { 0.5f,1,0.5f, 1.f }, { 0,1,0, 1.f } };
+    mesh_components[interact::translate_z]      = { make_lathed_lods({ 0,0,1 },{ 1,0,0 },{ 0,1,0 }, 16, arrow_points), { 0.5f,0.5f,1, 1.f }, { 0,0,1, 1.f } };
+    mesh_components[interact::translate_yz]     = { make_box_lods({ -0.01f,0.25,0.25 },{ 0.01f,0.75f,0.75f }), { 0.5f,1,1, 0.5f }, { 0,1,1, 0.6f } };
+    mesh_components[interact::translate_zx]     = { make_box_lods({ 0.25,-0.01f,0.25 },{ 0.75f,0.01f,0.75f }), { 1,0.5f,1, 0.5f }, { 1,0,1, 0.6f } };
+    mesh_components[interact::translate_xy]     = { make_box_lods({ 0.25,0.25,-0.01f },{ 0.75f,0.75f,0.01f }), { 1,1,0.5f, 0.5f }, { 1,1,0, 0.6f } };
+    mesh_components[interact::translate_xyz]    = { make_box_lods({ -0.05f,-0.05f,-0.05f },{ 0.05f,0.05f,0.05f }),{ 0.9f, 0.9f, 0.9f, 0.25f },{ 1,1,1, 0.35f } };
+    mesh_components[interact::rotate_x]         = { make_lathed_lods({ 1,0,0 },{ 0,1,0 },{ 0,0,1 }, 32, ring_points, 0.003f), { 1, 0.5f, 0.5f, 1.f }, { 1, 0, 0, 1.f } };
+    mesh_components[interact::rotate_y]         = { make_lathed_lods({ 0,1,0 },{ 0,0,1 },{ 1,0,0 }, 32, ring_points, -0.003f), { 0.5f,1,0.5f, 1.f }, { 0,1,0, 1.f } };
+    mesh_components[interact::rotate_z]         = { make_lathed_lods({ 0,0,1 },{ 1,0,0 },{ 0,1,0 }, 32, ring_points), { 0.5f,0.5f,1, 1.f }, { 0,0,1, 1.f } };
+    mesh_components[interact::scale_x]          = { make_lathed_lods({ 1,0,0 },{ 0,1,0 },{ 0,0,1 }, 16, mace_points),{ 1,0.5f,0.5f, 1.f },{ 1,0,0, 1.f } };
+    mesh_components[interact::scale_y]          = { make_lathed_lods({ 0,1,0 },{ 0,0,1 },{ 1,0,0 }, 16, mace_points),{ 0.5f,1,0.5f, 1.f },{ 0,1,0, 1.f } };
+    mesh_components[interact::scale_z]          = { make_lathed_lods({ 0,0,1 },{ 1,0,0 },{ 0,1,0 }, 16, mace_points),{ 0.5f,0.5f,1, 1.f },{ 0,0,1, 1.f } };
+
+    // Reorder the meshes for the post-transform cache. Rings keep their generation order, which `extract_lathed_slices(...)` relies on
+    for (auto & c : mesh_components)
+    {
+        if (c.first == interact::rotate_x || c.first == interact::rotate_y || c.first == interact::rotate_z) continue;
+        for (auto & m : c.second.mesh) optimize_geometry(m);
+    }
+
+    line_components[interact::translate_x]      = make_line_lods(make_shaft_lines({ 1,0,0 },{ 0,1,0 },{ 0,0,1 }, 0.25f, 1, 0.2f, 0.1f, true));
+    line_components[interact::translate_y]      = make_line_lods(make_shaft_lines({ 0,1,0 },{ 0,0,1 },{ 1,0,0 }, 0.25f, 1, 0.2f, 0.1f, true));
+    line_components[interact::translate_z]      = make_line_lods(make_shaft_lines({ 0,0,1 },{ 1,0,0 },{ 0,1,0 }, 0.25f, 1, 0.2f, 0.1f, true));
+    line_components[interact::translate_yz]     = make_line_lods(make_box_lines({ -0.01f,0.25,0.25 },{ 0.01f,0.75f,0.75f }));
+    line_components[interact::translate_zx]     = make_line_lods(make_box_lines({ 0.25,-0.01f,0.25 },{ 0.75f,0.01f,0.75f }));
+    line_components[interact::translate_xy]     = make_line_lods(make_box_lines({ 0.25,0.25,-0.01f },{ 0.75f,0.75f,0.01f }));
+    line_components[interact::translate_xyz]    = make_line_lods(make_box_lines({ -0.05f,-0.05f,-0.05f },{ 0.05f,0.05f,0.05f }));
+    line_components[interact::rotate_x]         = make_ring_line_lods({ 0,1,0 },{ 0,0,1 }, 32, 1.05f);
+    line_components[interact::rotate_y]         = make_ring_line_lods({ 0,0,1 },{ 1,0,0 }, 32, 1.05f);
+    line_components[interact::rotate_z]         = make_ring_line_lods({ 1,0,0 },{ 0,1,0 }, 32, 1.05f);
+    line_components[interact::scale_x]          = make_line_lods(make_shaft_lines({ 1,0,0 },{ 0,1,0 },{ 0,0,1 }, 0.25f, 1, 0.25f, 0.1f, false));
+    line_components[interact::scale_y]          = make_line_lods(make_shaft_lines({ 0,1,0 },{ 0,0,1 },{ 1,0,0 }, 0.25f, 1, 0.25f, 0.1f, false));
+    line_components[interact::scale_z]          = make_line_lods(make_shaft_lines({ 0,0,1 },{ 1,0,0 },{ 0,1,0 }, 0.25f, 1, 0.25f, 0.1f, false));
+
+    // Analytic impostors matching the profiles above
+    auto shaft = [](impostor_shape shape, float3 axis, float start, float end, float radius, float head_length, float head_radius)
+    {
+        gizmo_impostor i = {};
+        i.shape = shape;
+        i.shaft = { axis, start, end, radius, head_length, head_radius };
+        return i;
+    };
+    auto ring = [](float3 axis) { gizmo_impostor i = {}; i.shape = impostor_shape::ring; i.ring = { axis, 1.05f, 0.05f, 0.025f }; return i; };
+    auto box = [](float3 min_bounds, float3 max_bounds) { gizmo_impostor i = {}; i.shape = impostor_shape::box; i.box = { (min_bounds + max_bounds) * 0.5f, (max_bounds - min_bounds) * 0.5f }; return i; };
+    impostor_shapes[interact::translate_x]      = shaft(impostor_shape::arrow, { 1,0,0 }, 0.25f, 1, 0.05f, 0.2f, 0.1f);
+    impostor_shapes[interact::translate_y]      = shaft(impostor_shape::arrow, { 0,1,0 }, 0.25f, 1, 0.05f, 0.2f, 0.1f);
+    impostor_shapes[interact::translate_z]      = shaft(impostor_shape::arrow, { 0,0,1 }, 0.25f, 1, 0.05f, 0.2f, 0.1f);
+    impostor_shapes[interact::translate_yz]     = box({ -0.01f,0.25,0.25 },{ 0.01f,0.75f,0.75f });
+    impostor_shapes[interact::translate_zx]     = box({ 0.25,-0.01f,0.25 },{ 0.75f,0.01f,0.75f });
+    impostor_shapes[interact::translate_xy]     = box({ 0.25,0.25,-0.01f },{ 0.75f,0.75f,0.01f });
+    impostor_shapes[interact::translate_xyz]    = box({ -0.05f,-0.05f,-0.05f },{ 0.05f,0.05f,0.05f });
+    impostor_shapes[interact::rotate_x]         = ring({ 1,0,0 });
+    impostor_shapes[interact::rotate_y]         = ring({ 0,1,0 });
+    impostor_shapes[interact::rotate_z]         = ring({ 0,0,1 });
+    impostor_shapes[interact::scale_x]          = shaft(impostor_shape::mace, { 1,0,0 }, 0.25f, 1, 0.05f, 0.25f, 0.1f);
+    impostor_shapes[interact::scale_y]          = shaft(impostor_shape::mace, { 0,1,0 }, 0.25f, 1, 0.05f, 0.25f, 0.1f);
+    impostor_shapes[interact::scale_z]          = shaft(impostor_shape::mace, { 0,0,1 }, 0.25f, 1, 0.05f, 0.25f, 0.1f);
+}
+
+// Axes of the camera frame under the build's coordinate convention. The axis is always a constant, so the switch folds away.
+float3 qaxis(const float4 & q, const axis a)
+{
+    switch (a)
+    {
+    case axis::pos_x: return qxdir(q);
+    case axis::neg_x: return -qxdir(q);
+    case axis::pos_y: return qydir(q);
+    case axis::neg_y: return -qydir(q);
+    case axis::pos_z: return qzdir(q);
+    default: return -qzdir(q);
+    }
+}
+float3 camera_right(const camera_parameters & cam) { return qaxis(cam.orientation, convention::right); }
+float3 camera_up(const camera_parameters & cam) { return qaxis(cam.orientation, convention::up); }
+float3 camera_forward(const camera_parameters & cam) { return qaxis(cam.orientation, convention::forward); }
+
+// The center eye of a stereo pair. Screen-space scale, level of detail and every other view-dependent choice is made once
+// for this camera, so that both eyes see the same geometry.
+camera_parameters center_eye(const camera_parameters & left, const camera_parameters & right)
+{
+    camera_parameters cam;
+    cam.position = (left.position + right.position) * 0.5f;
+    cam.orientation = qnlerp(left.orientation, right.orientation, 0.5f);
+    cam.yfov = std::max(left.yfov, right.yfov);
+    cam.near_clip = std::min(left.near_clip, right.near_clip);
+    cam.far_clip = std::max(left.far_clip, right.far_clip);
+    cam.orthographic = left.orthographic && right.orthographic;
+    cam.ortho_height = std::max(left.ortho_height, right.ortho_height);
+    return cam;
+}
+
+float4x4 view_projection_matrix(const camera_parameters & cam, const float aspect)
+{
+    // The view matrix maps the camera frame of any convention onto the x right, y up and -z forward frame of the projection
+    const float4x4 view = mul(transpose(float4x4{ { camera_right(cam),0 },{ camera_up(cam),0 },{ -camera_forward(cam),0 },{ 0,0,0,1 } }), translation_matrix(-cam.position));
+    if (cam.orthographic)
+    {
+        const float y = cam.ortho_height / 2, x = y * aspect;
+        return mul(orthographic_matrix(-x, x, -y, y, cam.near_clip, cam.far_clip, neg_z, convention::depth), view);
+    }
+    return mul(perspective_matrix(cam.yfov, aspect, cam.near_clip, cam.far_clip, neg_z, convention::depth), view);
+}
+
+// Gribb and Hartmann: each plane is a sum or difference of the rows of the view projection
+frustum make_frustum(const float4x4 & view_projection)
+{
+    const float4 x = view_projection.row(0), y = view_projection.row(1), z = view_projection.row(2), w = view_projection.row(3);
+    frustum f = { { convention::depth == zero_to_one ? z : w + z, w - z, w + x, w - x, w + y, w - y } };
+    for (auto & p : f.planes) p /= length(p.xyz());
+    return f;
+}
+
+// With `camera_matrices`, the camera pose is the rigid inverse of the app's view matrix. Its view direction, clip planes and field of
+// view, and the pick ray, are recovered from the inverse view projection by unprojection, which holds under any convention: the
+// camera looks down whichever of -z and +z of its view space leads from the near plane to the far plane. An orthographic projection,
+// whose last row is (0,0,0,1), casts the ray from the cursor on the near plane along the view direction.
+void apply_camera_matrices(gizmo_application_state & state)
+{
+    const float4x4 & inverse_view_projection = state.inverse_view_projection;
+    const auto unproject = [&inverse_view_projection](const float3 & ndc) { const float4 p = mul(inverse_view_projection, float4(ndc, 1)); return p.xyz() / p.w; };
+    const float near_z = convention::depth == zero_to_one ? 0.f : -1.f;
+    const bool orthographic = state.projection.row(3) == float4(0, 0, 0, 1);
+
+    const float4x4 pose = inverse_rigid(state.view);
+    const float3 eye = pose.w.xyz(), right = pose.x.xyz(), up = pose.y.xyz();
+    const float3 center = unproject({ 0, 0, near_z }), top = unproject({ 0, 1, near_z });
+    const float3 forward = dot(unproject({ 0, 0, 1 }) - center, pose.z.xyz()) < 0 ? -pose.z.xyz() : pose.z.xyz();
+
+    float3x3 frame;
+    frame[axis_index(convention::right)] = right * axis_sign(convention::right);
+    frame[axis_index(convention::up)] = up * axis_sign(convention::up);
+    frame[axis_index(convention::forward)] = forward * axis_sign(convention::forward);
+    state.cam.position = eye;
+    state.cam.orientation = normalize(rotation_quat(frame));
+    state.cam.near_clip = dot(center - eye, forward);
+    state.cam.far_clip = dot(unproject({ 0, 0, 1 }) - eye, forward);
+    state.cam.orthographic = orthographic;
+    state.cam.ortho_height = orthographic ? 2 * length(top - center) : 0.f;
+    state.cam.yfov = orthographic ? 0.f : 2 * std::atan(length(top - center) / state.cam.near_clip);
+
+    const float2 ndc = { 2 * state.cursor.x / state.viewport_size.x - 1, 1 - 2 * state.cursor.y / state.viewport_size.y };
+    state.ray_origin = orthographic ? unproject({ ndc, near_z }) : eye;
+    state.ray_direction = orthographic ? forward : normalize(unproject({ ndc, near_z }) - eye);
+}
+
+camera_frame make_camera_frame(const gizmo_application_state & state)
+{
+    const float aspect = state.viewport_size.x / state.viewport_size.y;
+    camera_frame c;
+    c.forward = camera_forward(state.cam);
+    c.orthographic = state.cam.orthographic;
+    c.tan_yfov = trig_tan(state.cam.yfov);
+    c.view_projection = state.camera_matrices ? mul(state.projection, state.view) : view_projection_matrix(state.cam, aspect);
+    c.frustum_count = state.stereo ? 2 : 1;
+    if (state.stereo) for (int i = 0; i < 2; ++i) c.frusta[i] = make_frustum(view_projection_matrix(state.eyes[i], aspect));
+    else c.frusta[0] = make_frustum(c.view_projection);
+    return c;
+}
+
+float4x4 make_output_matrix(const gizmo_application_state & state, const float4x4 & view_projection)
+{
+    float4x4 output_matrix = { { 1,0,0,0 },{ 0,1,0,0 },{ 0,0,1,0 },{ 0,0,0,1 } };
+    if (state.output_space != geometry_space::world)
+    {
+        output_matrix = view_projection;
+        if (state.output_space == geometry_space::screen)
+        {
+            const float2 half = state.viewport_size * 0.5f;
+            output_matrix = mul(float4x4{ { half.x,0,0,0 },{ 0,-half.y,0,0 },{ 0,0,1,0 },{ half.x,half.y,0,1 } }, output_matrix);
+        }
+    }
+    return output_matrix;
 }
 
 void gizmo_context::gizmo_context_impl::update(const gizmo_application_state & state)
 {
-    active_state = state;
+    update(state, {});
+}
+
+void gizmo_context::gizmo_context_impl::update(const gizmo_application_state & state, const std::vector<gizmo_viewport> & views)
+{
+    // Release the geometry of gizmos that were not emitted during the last frame, so that the cache does not grow with every
+    // gizmo ever shown. Revisions are never reused, so outputs keyed by entry and revision stay correct if an address is reused.
+    for (auto it = draw_cache.begin(); it != draw_cache.end();) it = (it->second.frame == frame) ? std::next(it) : draw_cache.erase(it);
+    ++frame;
+
+    input_state = state;
+    if (input_state.stereo)
+    {
+        input_state.cam = center_eye(state.eyes[0], state.eyes[1]);
+        input_state.camera_matrices = false;
+        input_state.output_space = geometry_space::world;
+    }
+
+    // Picking moves to the hovered viewport, except while the mouse button is held so that a drag stays in its viewport
+    viewports = views;
+    if (!state.mouse_left || !last_state.mouse_left)
+    {
+        for (uint32_t i = 0; i < (uint32_t) viewports.size(); ++i) if (viewports[i].hovered) active_viewport = i;
+    }
+    if (active_viewport >= std::max<uint32_t>((uint32_t) viewports.size(), 1)) active_viewport = 0;
+    viewport_drawlists.resize(viewports.size());
+    for (auto & list : viewport_drawlists) list.clear();
+    use_viewport(active_viewport);
+
     local_toggle = (!last_state.hotkey_local && active_state.hotkey_local && active_state.hotkey_ctrl) ? !local_toggle : local_toggle;
     has_clicked = (!last_state.mouse_left && active_state.mouse_left) ? true : false;
     has_released = (last_state.mouse_left && !active_state.mouse_left) ? true : false;
     drawlist.clear();
+    stats = {};
+}
+
+// Apply the camera, scale and ray of a viewport to `active_state`, and direct emitted geometry to its drawlist
+void gizmo_context::gizmo_context_impl::use_viewport(uint32_t index)
+{
+    active_state = input_state;
+    if (index < viewports.size())
+    {
+        const gizmo_viewport & v = viewports[index];
+        active_state.cam = v.cam;
+        active_state.viewport_size = v.viewport_size;
+        active_state.screenspace_scale = v.screenspace_scale;
+        active_state.ray_origin = v.ray_origin;
+        active_state.ray_direction = v.ray_direction;
+        active_state.camera_matrices = false;
+    }
+    else if (active_state.camera_matrices) apply_camera_matrices(active_state);
+    current_viewport = index;
+    interactive = index == active_viewport;
+    camera = make_camera_frame(active_state);
+    output_matrix = make_output_matrix(active_state, camera.view_projection);
 }
 
 void gizmo_context::gizmo_context_impl::draw()
 {
+    // The output only needs to be rebuilt if the set of drawn gizmos, or the geometry of one of them, changed since the last call.
+    // Comparing revisions rather than a per-frame flag keeps changes made in frames that were never drawn.
+    contents.clear();
+    for (auto * d : drawlist) contents.push_back({ d, d->revision });
+    if (contents != drawn_contents)
+    {
+        drawn_contents.swap(contents);
+        ++generation;
+    }
+
+    // The gizmo functions leave the active viewport applied, but all outputs except `render_viewport` hold viewport 0's drawlist,
+    // so its camera must be used to sort and orient them
+    if (current_viewport != 0) use_viewport(0);
+
+    dirty_ranges.clear();
     if (ctx->render)
     {
-        geometry_mesh r; // Combine all gizmo sub-meshes into one super-mesh
-        for (auto & m : drawlist)
+        if (merged_generation != generation)
+        {
+            // Gizmos appearing or disappearing compacts the layout; otherwise only the slots of changed gizmos are rewritten
+            if (drawlist != merged_drawlist) layout_merged();
+            else
+            {
+                const size_t numVerts = merged.vertices.size(), numTris = merged.triangles.size();
+                for (size_t i = 0; i < slots.size(); ++i) if (slots[i].revision != drawlist[i]->revision) write_slot(i);
+
+                // A slot that outgrew its capacity was moved to the end, so the buffers must be reallocated and uploaded in full
+                if (merged.vertices.size() != numVerts || merged.triangles.size() != numTris)
+                {
+                    dirty_ranges = { { 0, (uint32_t) merged.vertices.size(), 0, (uint32_t) merged.triangles.size() } };
+                }
+            }
+            merged_generation = generation;
+        }
+        ctx->render(merged);
+    }
+    if (ctx->render_streams)
+    {
+        if (streams_generation != generation)
+        {
+            streams.positions.clear(); streams.normals.clear(); streams.colors.clear(); streams.triangles.clear();
+            for (auto * d : drawlist) for (auto & m : d->renderables)
+            {
+                uint32_t numVerts = (uint32_t) streams.positions.size();
+                for (auto & v : m.mesh.vertices) { streams.positions.push_back(v.position); streams.normals.push_back(v.normal); }
+                streams.colors.insert(streams.colors.end(), m.mesh.vertices.size(), m.color);
+                for (auto & f : m.mesh.triangles) streams.triangles.push_back({ numVerts + f.x, numVerts + f.y, numVerts + f.z });
+            }
+            streams_generation = generation;
+        }
+        ctx->render_streams(streams);
+    }
+    if (ctx->render_chunk)
+    {
+        // Streamed from the retained per-gizmo geometry, so the only memory specific to this output is the two chunk buffers
+        uint32_t current = 0;
+        chunks[current].vertices.clear(); chunks[current].triangles.clear();
+        for (auto * d : drawlist) for (auto & m : d->renderables)
+        {
+            assert(m.mesh.vertices.size() <= max_chunk_vertices);
+            if (chunks[current].vertices.size() + m.mesh.vertices.size() > max_chunk_vertices)
+            {
+                ctx->render_chunk(chunks[current]);
+                current ^= 1;
+                chunks[current].vertices.clear(); chunks[current].triangles.clear();
+            }
+
+            const uint16_t numVerts = (uint16_t) chunks[current].vertices.size();
+            auto it = chunks[current].vertices.insert(chunks[current].vertices.end(), m.mesh.vertices.begin(), m.mesh.vertices.end());
+            for (auto & f : m.mesh.triangles) chunks[current].triangles.push_back({ uint16_t(numVerts + f.x), uint16_t(numVerts + f.y), uint16_t(numVerts + f.z) });
+            for (; it != chunks[current].vertices.end(); ++it) it->color = m.color;
+        }
+        if (!chunks[current].vertices.empty()) ctx->render_chunk(chunks[current]);
+    }
+    if (ctx->render_batches)
+    {
+        bool rebuild = batches_generation != generation;
+        if (rebuild)
+        {
+            opaque_batch.vertices.clear(); opaque_batch.triangles.clear();
+            transparent.clear();
+            for (auto * d : drawlist) for (auto & m : d->renderables)
+            {
+                if (m.color.w < 1.f) transparent.push_back(&m);
+                else append_renderable(kernels, opaque_batch, m);
+            }
+            batches_generation = generation;
+        }
+
+        // The view depth of each translucent component's centroid is quantized to 16 bits over the range of depths in the batch.
+        // Projected output already has monotonic depth in z.
+        const float3 eye = active_state.cam.position, forward = camera.forward;
+        transparent_depths.resize(transparent.size());
+        float min_depth = std::numeric_limits<float>::infinity(), max_depth = -min_depth;
+        for (size_t i = 0; i < transparent.size(); ++i)
+        {
+            float3 centroid;
+            for (auto & v : transparent[i]->mesh.vertices) centroid += v.position;
+            centroid /= (float) std::max<size_t>(transparent[i]->mesh.vertices.size(), 1);
+            const float depth = (active_state.output_space == geometry_space::world) ? dot(centroid - eye, forward) : centroid.z;
+            transparent_depths[i] = depth;
+            min_depth = std::min(min_depth, depth);
+            max_depth = std::max(max_depth, depth);
+        }
+        const float quantize = (max_depth > min_depth) ? 65535.f / (max_depth - min_depth) : 0.f;
+        depth_keys.resize(transparent.size());
+        for (size_t i = 0; i < transparent.size(); ++i)
+        {
+            depth_keys[i] = { (uint16_t) ((max_depth - transparent_depths[i]) * quantize), (uint32_t) i }; // Farthest first
+        }
+        radix_sort(depth_keys, depth_scratch);
+
+        // The translucent mesh is only rewritten if its components or their order changed
+        bool reordered = transparent_order.size() != depth_keys.size();
+        transparent_order.resize(depth_keys.size());
+        for (size_t i = 0; i < depth_keys.size(); ++i)
+        {
+            reordered |= transparent_order[i] != depth_keys[i].index;
+            transparent_order[i] = depth_keys[i].index;
+        }
+        if (rebuild || reordered)
+        {
+            transparent_batch.vertices.clear(); transparent_batch.triangles.clear();
+            for (auto i : transparent_order) append_renderable(kernels, transparent_batch, *transparent[i]);
+        }
+        ctx->render_batches(opaque_batch, transparent_batch);
+    }
+    if (ctx->render_viewport)
+    {
+        // Each viewport mesh is rebuilt only if its gizmos, or the geometry of one of them, changed
+        const size_t count = std::max<size_t>(viewports.size(), 1);
+        viewport_meshes.resize(count);
+        viewport_contents.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const std::vector<gizmo_draw_cache *> & list = i ? viewport_drawlists[i] : drawlist;
+            contents.clear();
+            for (auto * d : list) contents.push_back({ d, d->revision });
+            if (contents != viewport_contents[i])
+            {
+                geometry_mesh & mesh = viewport_meshes[i];
+                mesh.vertices.clear(); mesh.triangles.clear();
+                for (auto * d : list) for (auto & m : d->renderables) append_renderable(kernels, mesh, m);
+                viewport_contents[i].swap(contents);
+            }
+            ctx->render_viewport((uint32_t) i, viewport_meshes[i]);
+        }
+    }
+    if (ctx->render_lines)
+    {
+        if (lines_generation != generation)
+        {
+            // The lines of each component were already transformed and colored by `emit(...)`; decorations have none
+            lines.vertices.clear(); lines.lines.clear();
+            for (auto * d : drawlist) for (auto & m : d->renderables)
+            {
+                const uint32_t numVerts = (uint32_t) lines.vertices.size();
+                lines.vertices.insert(lines.vertices.end(), m.lines.vertices.begin(), m.lines.vertices.end());
+                for (auto & s : m.lines.lines) lines.lines.push_back({ numVerts + s.x, numVerts + s.y });
+            }
+            lines_generation = generation;
+        }
+        ctx->render_lines(lines);
+    }
+    if (ctx->render_impostors)
+    {
+        // Impostors are always emitted in world space, since their distance functions are evaluated there
+        impostors.clear();
+        for (auto * d : drawlist)
         {
-            uint32_t numVerts = (uint32_t) r.vertices.size();
-            auto it = r.vertices.insert(r.vertices.end(), m.mesh.vertices.begin(), m.mesh.vertices.end());
-            for (auto & f : m.mesh.triangles) r.triangles.push_back({numVerts + f.x, numVerts + f.y, numVerts + f.z });
-            for (; it != r.vertices.end(); ++it) it->color = m.color; // Take the color and shove it into a per-vertex attribute
+            // Recover the gizmo frame from its model matrix, which is a rotation scaled uniformly by the draw scale
+            const float scale = length(d->model.x.xyz());
+            const float4 orientation = rotation_quat(float3x3(d->model.x.xyz() / scale, d->model.y.xyz() / scale, d->model.z.xyz() / scale));
+            for (auto & m : d->renderables)
+            {
+                if (m.component == interact::none) continue; // Decorations have no analytic representation
+
+                gizmo_impostor i = impostor_shapes[m.component];
+                i.origin = d->model.w.xyz();
+                i.scale = scale;
+                i.orientation = orientation;
+                i.color = m.color;
+                i.component = m.component;
+                impostors.push_back(i);
+            }
+        }
+        ctx->render_impostors(impostors);
+    }
+    if (ctx->render_component)
+    {
+        for (auto * d : drawlist) for (auto & m : d->renderables)
+        {
+            const geometry_view v = { m.mesh.vertices.data(), (uint32_t) m.mesh.vertices.size(), m.mesh.triangles.data(), (uint32_t) m.mesh.triangles.size(), m.color, m.component, d->id };
+            ctx->render_component(v);
         }
-        ctx->render(r);
     }
     last_state = active_state;
 }
 
+// Write the renderables of `merged_drawlist[index]` into its slot, moving the slot to the end of the buffers if it no longer fits
+void gizmo_context::gizmo_context_impl::write_slot(size_t index)
+{
+    const gizmo_draw_cache & d = *merged_drawlist[index];
+    geometry_slot & slot = slots[index];
+
+    uint32_t numVerts = 0, numTris = 0;
+    for (auto & m : d.renderables) { numVerts += (uint32_t) m.mesh.vertices.size(); numTris += (uint32_t) m.mesh.triangles.size(); }
+
+    if (numVerts > slot.vertex_capacity || numTris > slot.triangle_capacity)
+    {
+        // Leave the old slot behind as degenerate triangles; the space is reclaimed the next time the layout is compacted
+        std::fill(merged.triangles.begin() + slot.triangle_offset, merged.triangles.begin() + slot.triangle_offset + slot.triangle_capacity, uint3(slot.vertex_offset));
+        dirty_ranges.push_back({ slot.vertex_offset, 0, slot.triangle_offset, slot.triangle_capacity });
+        slot.vertex_offset = (uint32_t) merged.vertices.size();
+        slot.triangle_offset = (uint32_t) merged.triangles.size();
+        slot.vertex_capacity = numVerts;
+        slot.triangle_capacity = numTris;
+        merged.vertices.resize(merged.vertices.size() + numVerts);
+        merged.triangles.resize(merged.triangles.size() + numTris);
+    }
+
+    uint32_t v = slot.vertex_offset, t = slot.triangle_offset;
+    for (auto & m : d.renderables)
+    {
+        kernels.merge_renderable(m, merged.vertices.data() + v, merged.triangles.data() + t, v); // The color becomes a per-vertex attribute
+        v += (uint32_t) m.mesh.vertices.size();
+        t += (uint32_t) m.mesh.triangles.size();
+    }
+    std::fill(merged.triangles.begin() + t, merged.triangles.begin() + slot.triangle_offset + slot.triangle_capacity, uint3(slot.vertex_offset));
+
+    dirty_ranges.push_back({ slot.vertex_offset, numVerts, slot.triangle_offset, slot.triangle_capacity });
+    slot.revision = d.revision;
+}
+
+// Assign every gizmo in the drawlist a tightly packed slot and write all of them
+void gizmo_context::gizmo_context_impl::layout_merged()
+{
+    merged_drawlist = drawlist;
+    slots.assign(drawlist.size(), geometry_slot{ 0, 0, 0, 0, 0 });
+    merged.vertices.clear();
+    merged.triangles.clear();
+    for (size_t i = 0; i < slots.size(); ++i) write_slot(i);
+    dirty_ranges = { { 0, (uint32_t) merged.vertices.size(), 0, (uint32_t) merged.triangles.size() } };
+}
+
 // This will calculate a scale constant based on the number of screenspace pixels passed as pixel_scale.
 float scale_screenspace(gizmo_context::gizmo_context_impl & g, const float3 position, const float pixel_scale)
 {
+    if (g.camera.orthographic) return g.active_state.cam.ortho_height * (pixel_scale / g.active_state.viewport_size.y);
     float dist = length(position - g.active_state.cam.position);
-    return std::tan(g.active_state.cam.yfov) * dist * (pixel_scale / g.active_state.viewport_size.y);
+    return g.camera.tan_yfov * dist * (pixel_scale / g.active_state.viewport_size.y);
+}
+
+// Direction from `point` toward the viewer, not normalized. Every point sees an orthographic camera along its view direction.
+float3 toward_viewer(const gizmo_context::gizmo_context_impl & g, const float3 & point)
+{
+    return g.camera.orthographic ? -g.camera.forward : g.active_state.cam.position - point;
+}
+
+// Whether any of the callbacks consumes triangle meshes. With only `render_lines` or `render_impostors` set, none are generated.
+bool wants_triangles(const gizmo_context & ctx)
+{
+    return ctx.render || ctx.render_streams || ctx.render_chunk || ctx.render_batches || ctx.render_viewport || ctx.render_component;
+}
+
+// Transform the given components into worldspace and append them to the drawlist. The geometry from the previous frame is reused
+// if the gizmo's model matrix, mode and highlighted component are unchanged. The space only matters through the model matrix, so
+// the local toggle is not part of the key. Returns true if it was regenerated.
+// Gizmos may replace component meshes and lines with view-dependent variants through `meshes` and `line_lists`, in which case
+// `variant` must identify them.
+bool emit(gizmo_context::gizmo_context_impl & g, const uint32_t id, const float4x4 & modelMatrix, const std::vector<interact> & components, const int lod, const bool force,
+    const geometry_mesh * const * meshes = nullptr, const geometry_lines * const * line_lists = nullptr, const uint32_t variant = 0)
+{
+    gizmo_draw_cache & cache = g.draw_cache[(uint64_t(g.current_viewport) << 32) | id];
+    const interact highlight = g.gizmos[id].interaction_mode;
+    (g.current_viewport ? g.viewport_drawlists[g.current_viewport] : g.drawlist).push_back(&cache);
+    cache.frame = g.frame;
+
+    const uint32_t hidden = g.gizmos[id].hidden;
+    size_t visible = 0;
+    for (auto c : components) if (!(hidden & (1u << uint32_t(c)))) ++visible;
+    g.stats.components_hidden += uint32_t(components.size() - visible);
+
+    const float4x4 output = mul(g.output_matrix, modelMatrix);
+    const bool triangles = wants_triangles(*g.ctx), lines = (bool) g.ctx->render_lines;
+    if (!force && cache.valid && cache.model == modelMatrix && cache.output == output && cache.components == components && cache.highlight == highlight && cache.lod == lod && cache.variant == variant && cache.hidden == hidden && cache.triangles == triangles && cache.lines == lines) return false;
+
+    cache.valid = true;
+    cache.id = id;
+    cache.model = modelMatrix;
+    cache.output = output;
+    cache.components = components;
+    cache.highlight = highlight;
+    cache.lod = lod;
+    cache.variant = variant;
+    cache.hidden = hidden;
+    cache.triangles = triangles;
+    cache.lines = lines;
+    cache.revision = ++g.revisions;
+    cache.renderables.resize(visible);
+    for (size_t i = 0, n = 0; i < components.size(); ++i)
+    {
+        const interact c = components[i];
+        if (hidden & (1u << uint32_t(c))) continue;
+        gizmo_renderable & r = cache.renderables[n++];
+        r.color = (c == highlight) ? g.mesh_components[c].base_color : g.mesh_components[c].highlight_color;
+        r.component = c;
+        if (triangles)
+        {
+            r.mesh = (meshes && meshes[i]) ? *meshes[i] : g.mesh_components[c].mesh[lod];
+            g.kernels.transform_vertices(output, modelMatrix, r.mesh.vertices); // transform local coordinates into the output space
+        }
+        else r.mesh = geometry_mesh();
+        if (lines)
+        {
+            // Line vertices carry no normal, so only their positions are transformed
+            const geometry_lines & l = (line_lists && line_lists[i]) ? *line_lists[i] : g.line_components[c][lod];
+            r.lines.vertices.resize(l.vertices.size());
+            for (size_t j = 0; j < l.vertices.size(); ++j) r.lines.vertices[j] = { transform_coord(output, l.vertices[j].position), float3(0.f), r.color };
+            r.lines.lines = l.lines;
+        }
+        else r.lines = geometry_lines();
+    }
+    return true;
+}
+
+// Select a level of detail from the projected size of the gizmo in pixels. A gizmo only moves to a finer level once it exceeds
+// the threshold by a margin (and vice versa), so that gizmos hovering around a threshold do not pop between levels.
+int select_lod(gizmo_context::gizmo_context_impl & g, const uint32_t id, const float3 position, const float draw_scale)
+{
+    static const float gizmo_extent = 1.25f;                // Length of the longest component in gizmo units
+    static const float lod_pixels[lod_count - 1] = { 64.f, 24.f }; // Projected size below which each coarser level is used
+    static const float hysteresis = 0.15f;
+
+    // The level is kept per viewport, and the one of the active viewport is used for picking
+    int & lod = g.draw_cache[(uint64_t(g.current_viewport) << 32) | id].selected_lod;
+    const float pixels = gizmo_extent * draw_scale / scale_screenspace(g, position, 1.f);
+    while (lod > 0 && pixels > lod_pixels[lod - 1] * (1.f + hysteresis)) --lod;
+    while (lod < lod_count - 1 && pixels < lod_pixels[lod] * (1.f - hysteresis)) ++lod;
+    if (g.interactive) g.gizmos[id].lod = lod;
+    return lod;
+}
+
+// Gizmos entirely behind the camera, outside the view frustum or smaller than a pixel are neither picked nor drawn. A gizmo
+// that is being dragged is never culled, so that the drag continues when it leaves the view.
+enum class sphere_visibility { visible, behind, outside };
+sphere_visibility classify_sphere(const frustum & f, const float3 & center, const float radius)
+{
+    if (dot(f.planes[0].xyz(), center) + f.planes[0].w < -radius) return sphere_visibility::behind;
+    for (int i = 1; i < 6; ++i) if (dot(f.planes[i].xyz(), center) + f.planes[i].w < -radius) return sphere_visibility::outside;
+    return sphere_visibility::visible;
+}
+
+bool cull(gizmo_context::gizmo_context_impl & g, const uint32_t id, const float3 position, const float draw_scale)
+{
+    static const float gizmo_radius = 1.3f;                 // Bounding sphere of every component in gizmo units
+
+    interaction_state & interaction = g.gizmos[id];
+    g.stats.gizmos++;
+    if (interaction.active) return false;
+
+    // In stereo mode, a gizmo is only culled if neither eye can see it
+    const float radius = gizmo_radius * draw_scale;
+    sphere_visibility visibility = classify_sphere(g.camera.frusta[0], position, radius);
+    if (g.camera.frustum_count > 1) visibility = std::min(visibility, classify_sphere(g.camera.frusta[1], position, radius));
+
+    bool culled = true;
+    if (visibility == sphere_visibility::behind) g.stats.culled_behind++;
+    else if (visibility == sphere_visibility::outside) g.stats.culled_outside++;
+    else if (radius < scale_screenspace(g, position, 1.f)) g.stats.culled_subpixel++;
+    else culled = false;
+
+    if (culled && g.interactive) interaction.hover = false;
+    return culled;
 }
 
 // The only purpose of this is readability: to reduce the total column width of the intersect(...) statements in every gizmo
-bool intersect(gizmo_context::gizmo_context_impl & g, const ray & r, interact i, float & t, const float best_t)
+bool intersect(gizmo_context::gizmo_context_impl & g, const ray & r, const geometry_mesh & mesh, float & t, const float best_t)
 {
-    if (intersect_ray_mesh(r, g.mesh_components[i].mesh, &t) && t < best_t) return true;
+    if (g.kernels.intersect_ray_mesh(r, mesh, &t) && t < best_t) return true;
     return false;
 }
 
+// Line output is picked by the distance between the ray and each segment, which grows with depth so that the threshold is
+// constant in screen space. The ray must start at the camera, or on the near plane of an orthographic camera where the
+// threshold does not depend on depth, and t is the ray parameter of the closest approach.
+bool intersect_ray_lines(gizmo_context::gizmo_context_impl & g, const ray & r, const geometry_lines & lines, float & t, const float best_t)
+{
+    static const float pick_pixels = 8.f;
+    const float pixel_slope = g.camera.tan_yfov / g.active_state.viewport_size.y; // As in scale_screenspace(...)
+    const float pixel_size = g.active_state.cam.ortho_height / g.active_state.viewport_size.y;
+    const float dd = length2(r.direction);
+    bool hit = false;
+    for (auto & s : lines.lines)
+    {
+        // Closest points between the ray and the segment
+        const float3 a = lines.vertices[s.x].position, e = lines.vertices[s.y].position - a, w = r.origin - a;
+        const float de = dot(r.direction, e), ee = length2(e), dw = dot(r.direction, w), ew = dot(e, w);
+        const float denom = dd * ee - de * de;
+        float u = (denom > 1e-12f) ? clamp((dd * ew - de * dw) / denom, 0.f, 1.f) : 0.f;
+        float ray_t = std::max((de * u - dw) / dd, 0.f);
+        u = clamp((dot(r.origin + r.direction * ray_t - a, e)) / ee, 0.f, 1.f);
+
+        const float3 on_ray = r.origin + r.direction * ray_t;
+        const float distance = length(on_ray - (a + e * u)), depth = length(on_ray - r.origin);
+        const float threshold = g.camera.orthographic ? pick_pixels * pixel_size : pick_pixels * pixel_slope * depth;
+        if (ray_t > 0.f && ray_t < best_t && (!hit || ray_t < t) && distance < threshold)
+        {
+            t = ray_t;
+            hit = true;
+        }
+    }
+    return hit;
+}
+
+// Picks the lines when they are the output, so that what is picked is what is drawn
+bool intersect(gizmo_context::gizmo_context_impl & g, const ray & r, const geometry_mesh & mesh, const geometry_lines & lines, float & t, const float best_t)
+{
+    if (g.ctx->render_lines) return intersect_ray_lines(g, r, lines, t, best_t);
+    return intersect(g, r, mesh, t, best_t);
+}
+
+bool intersect(gizmo_context::gizmo_context_impl & g, const ray & r, const uint32_t id, interact i, float & t, const float best_t)
+{
+    const interaction_state & interaction = g.gizmos[id];
+    if (interaction.hidden & (1u << uint32_t(i))) return false;
+    return intersect(g, r, g.mesh_components[i].mesh[interaction.lod], g.line_components[i][interaction.lod], t, best_t);
+}
+
+// Arrows and maces pointing at the camera project to a point, and plane handles seen edge-on project to a line. Neither can
+// be dragged reliably, so they are hidden from drawing and picking, except for the component that is being dragged.
+void hide_degenerate_components(gizmo_context::gizmo_context_impl & g, const uint32_t id, const rigid_transform_inverse & inverse)
+{
+    static const float max_axis_alignment = 0.99f;         // Cosine of the angle between an axis and the view direction
+    static const float min_plane_alignment = 0.1f;         // Cosine of the angle between a plane normal and the view direction
+    static const interact axes[3][3] = {
+        { interact::translate_x, interact::translate_y, interact::translate_z },
+        { interact::scale_x, interact::scale_y, interact::scale_z },
+        { interact::translate_yz, interact::translate_zx, interact::translate_xy } };
+
+    interaction_state & interaction = g.gizmos[id];
+    const float3 view = normalize(inverse.detransform_vector(toward_viewer(g, inverse.position)));
+    interaction.hidden = 0;
+    for (int k = 0; k < 3; ++k)
+    {
+        const float alignment = std::abs(view[k]);
+        if (alignment > max_axis_alignment) interaction.hidden |= (1u << uint32_t(axes[0][k])) | (1u << uint32_t(axes[1][k]));
+        if (alignment < min_plane_alignment) interaction.hidden |= 1u << uint32_t(axes[2][k]);
+    }
+    if (interaction.active) interaction.hidden &= ~(1u << uint32_t(interaction.interaction_mode));
+}
+
 ///////////////////////////////////
 // Private Gizmo Implementations //
 ///////////////////////////////////
@@ -391,7 +1699,7 @@ void axis_rotation_dragger(const uint32_t id, gizmo_context::gizmo_context_impl
             float d = dot(arm1, arm2);
             if (d > 0.999f) { orientation = start_orientation; return; }
 
-            float angle = std::acos(d);
+            float angle = trig_acos(d);
             if (angle < 0.001f) { orientation = start_orientation; return; }
 
             if (g.active_state.snap_rotation)
@@ -402,7 +1710,7 @@ void axis_rotation_dragger(const uint32_t id, gizmo_context::gizmo_context_impl
             else
             {
                 auto a = normalize(cross(arm1, arm2));
-                orientation = qmul(rotation_quat(a, angle), start_orientation);
+                orientation = qmul(make_rotation_quat_axis_angle(a, angle), start_orientation);
             }
         }
     }
@@ -441,7 +1749,7 @@ void axis_translation_dragger(const uint32_t id, gizmo_context::gizmo_context_im
     if (g.active_state.mouse_left)
     {
         // First apply a plane translation dragger with a plane that contains the desired axis and is oriented to face the camera
-        const float3 plane_tangent = cross(axis, point - g.active_state.cam.position);
+        const float3 plane_tangent = cross(axis, -toward_viewer(g, point));
         const float3 plane_normal = cross(axis, plane_tangent);
         plane_translation_dragger(id, g, plane_normal, point);
 
@@ -454,28 +1762,52 @@ void axis_translation_dragger(const uint32_t id, gizmo_context::gizmo_context_im
 //   Gizmo Implementations   //
 ///////////////////////////////
 
-void position_gizmo(const std::string & name, gizmo_context::gizmo_context_impl & g, const float4 & orientation, float3 & position)
+// The gizmos are templates over their space and set of handles (bits of `components`, in the order of each gizmo's interactions)
+// so that the tests on either fold away. Only the default set of each gizmo is specialized; any other set is instantiated once as
+// `dynamic_components` and passed at runtime.
+static const uint32_t dynamic_components = 1u << 31;
+
+template<uint32_t Components> uint32_t handle_set(const uint32_t dynamic_set) { return Components == dynamic_components ? dynamic_set : Components; }
+
+// Writes the interactions whose bit is in `set` to `selected`, which is retained by the caller so that no allocation happens per frame
+const std::vector<interact> & select_components(std::initializer_list<interact> interactions, const uint32_t set, std::vector<interact> & selected)
+{
+    selected.clear();
+    uint32_t bit = 1;
+    for (auto i : interactions) { if (set & bit) selected.push_back(i); bit <<= 1; }
+    return selected;
+}
+
+template<gizmo_space Space, uint32_t Components>
+void position_gizmo(const std::string & name, gizmo_context::gizmo_context_impl & g, const float4 & orientation, float3 & position, const uint32_t dynamic_set = 0)
 {
-    rigid_transform p = rigid_transform(g.local_toggle ? orientation : float4(0, 0, 0, 1), position);
+    static const bool local = Space == gizmo_space::local;
+    const uint32_t set = handle_set<Components>(dynamic_set);
+    rigid_transform p = rigid_transform(local ? orientation : float4(0, 0, 0, 1), position);
+    const rigid_transform_inverse inverse(p);
     const float draw_scale = (g.active_state.screenspace_scale > 0.f) ? scale_screenspace(g, p.position, g.active_state.screenspace_scale) : 1.f;
     const uint32_t id = hash_fnv1a(name);
+    if (cull(g, id, p.position, draw_scale)) return;
+    const int lod = select_lod(g, id, p.position, draw_scale);
+    hide_degenerate_components(g, id, inverse);
 
     // interaction_mode will only change on clicked
-    if (g.has_clicked) g.gizmos[id].interaction_mode = interact::none;
+    if (g.interactive && g.has_clicked) g.gizmos[id].interaction_mode = interact::none;
 
+    if (g.interactive)
     {
         interact updated_state = interact::none;
-        auto ray = detransform(p, { g.active_state.ray_origin, g.active_state.ray_direction });
+        auto ray = detransform(inverse, { g.active_state.ray_origin, g.active_state.ray_direction });
         detransform(draw_scale, ray);
 
-        float best_t = std::numeric_limits<float>::infinity(), t;
-        if (intersect(g, ray, interact::translate_x, t, best_t)) { updated_state = interact::translate_x;     best_t = t; }
-        if (intersect(g, ray, interact::translate_y, t, best_t)) { updated_state = interact::translate_y;     best_t = t; }
-        if (intersect(g, ray, interact::translate_z, t, best_t)) { updated_state = interact::translate_z;     best_t = t; }
-        if (intersect(g, ray, interact::translate_yz, t, best_t)) { updated_state = interact::translate_yz;   best_t = t; }
-        if (intersect(g, ray, interact::translate_zx, t, best_t)) { updated_state = interact::translate_zx;   best_t = t; }
-        if (intersect(g, ray, interact::translate_xy, t, best_t)) { updated_state = interact::translate_xy;   best_t = t; }
-        if (intersect(g, ray, interact::translate_xyz, t, best_t)) { updated_state = interact::translate_xyz; best_t = t; }
+        float best_t = std::numeric_limits<float>::infinity(), t = 0.f;
+        if ((set & components::x) && intersect(g, ray, id, interact::translate_x, t, best_t)) { updated_state = interact::translate_x;            best_t = t; }
+        if ((set & components::y) && intersect(g, ray, id, interact::translate_y, t, best_t)) { updated_state = interact::translate_y;            best_t = t; }
+        if ((set & components::z) && intersect(g, ray, id, interact::translate_z, t, best_t)) { updated_state = interact::translate_z;            best_t = t; }
+        if ((set & components::yz_plane) && intersect(g, ray, id, interact::translate_yz, t, best_t)) { updated_state = interact::translate_yz;   best_t = t; }
+        if ((set & components::zx_plane) && intersect(g, ray, id, interact::translate_zx, t, best_t)) { updated_state = interact::translate_zx;   best_t = t; }
+        if ((set & components::xy_plane) && intersect(g, ray, id, interact::translate_xy, t, best_t)) { updated_state = interact::translate_xy;   best_t = t; }
+        if ((set & components::xyz) && intersect(g, ray, id, interact::translate_xyz, t, best_t)) { updated_state = interact::translate_xyz;      best_t = t; }
 
         if (g.has_clicked)
         {
@@ -484,7 +1816,7 @@ void position_gizmo(const std::string & name, gizmo_context::gizmo_context_impl
             if (g.gizmos[id].interaction_mode != interact::none)
             {
                 transform(draw_scale, ray);
-                g.gizmos[id].click_offset = g.local_toggle ? p.transform_vector(ray.origin + ray.direction*t) : ray.origin + ray.direction*t;
+                g.gizmos[id].click_offset = local ? p.transform_vector(ray.origin + ray.direction*t) : ray.origin + ray.direction*t;
                 g.gizmos[id].active = true;
             }
             else g.gizmos[id].active = false;
@@ -493,11 +1825,10 @@ void position_gizmo(const std::string & name, gizmo_context::gizmo_context_impl
         g.gizmos[id].hover = (best_t == std::numeric_limits<float>::infinity()) ? false : true;
     }
  
-    std::vector<float3> axes;
-    if (g.local_toggle) axes = { qxdir(p.orientation), qydir(p.orientation), qzdir(p.orientation) };
-    else axes = { { 1, 0, 0 },{ 0, 1, 0 },{ 0, 0, 1 } };
+    float3 axes[3] = { { 1, 0, 0 },{ 0, 1, 0 },{ 0, 0, 1 } };
+    if (local) { axes[0] = qxdir(p.orientation); axes[1] = qydir(p.orientation); axes[2] = qzdir(p.orientation); }
 
-    if (g.gizmos[id].active)
+    if (g.interactive && g.gizmos[id].active)
     {
         position += g.gizmos[id].click_offset;
         switch (g.gizmos[id].interaction_mode)
@@ -508,7 +1839,8 @@ void position_gizmo(const std::string & name, gizmo_context::gizmo_context_impl
         case interact::translate_yz: plane_translation_dragger(id, g, axes[0], position); break;
         case interact::translate_zx: plane_translation_dragger(id, g, axes[1], position); break;
         case interact::translate_xy: plane_translation_dragger(id, g, axes[2], position); break;
-        case interact::translate_xyz: plane_translation_dragger(id, g, -minalg::qzdir(g.active_state.cam.orientation), position); break;
+        case interact::translate_xyz: plane_translation_dragger(id, g, -g.camera.forward, position); break;
+        default: break;
         }
         position -= g.gizmos[id].click_offset;
     }
@@ -519,52 +1851,97 @@ void position_gizmo(const std::string & name, gizmo_context::gizmo_context_impl
         g.gizmos[id].active = false;
     }
 
-    std::vector<interact> draw_interactions
+    const std::vector<interact> & draw_interactions = select_components(
     {
         interact::translate_x, interact::translate_y, interact::translate_z,
         interact::translate_yz, interact::translate_zx, interact::translate_xy,
         interact::translate_xyz
-    };
+    }, set, g.selected_components);
 
     float4x4 modelMatrix = p.matrix();
     float4x4 scaleMatrix = scaling_matrix(float3(draw_scale));
     modelMatrix = mul(modelMatrix, scaleMatrix);
 
-    for (auto c : draw_interactions)
+    emit(g, id, modelMatrix, draw_interactions, lod, false);
+}
+
+// The half of a rotation ring starting at slice `first` of its `lod`. Only a few dozen such halves exist, so each is extracted once
+// and kept by the context; picking and drawing then share it, and a static gizmo copies no ring geometry per frame.
+const trimmed_ring_geometry & trimmed_ring(gizmo_context::gizmo_context_impl & g, const int ring, const int lod, const uint32_t first)
+{
+    const uint32_t slices = 32 >> lod;
+    const interact component = interact(int(interact::rotate_x) + ring);
+    trimmed_ring_geometry & trimmed = g.trimmed_rings[(uint32_t(ring) << 16) | (uint32_t(lod) << 8) | first];
+    if (trimmed.mesh.vertices.empty())
+    {
+        trimmed.mesh = extract_lathed_slices(g.mesh_components[component].mesh[lod], slices, first, slices / 2 + 1);
+        trimmed.lines = extract_ring_segments(g.line_components[component][lod], slices, first, slices / 2 + 1);
+    }
+    return trimmed;
+}
+
+// Rotation rings trimmed to their camera-facing half. Each ring is lathed from arm1 towards arm2, starting at tau/8.
+struct trimmed_rings
+{
+    const geometry_mesh * rings[3];         // Either the trimmed mesh or the full ring, if the camera looks down its axis
+    const geometry_lines * lines[3];        // The same as lines
+    uint32_t variant{ 0 };                  // First slice of each trimmed ring, packed to key the draw cache
+
+    trimmed_rings(gizmo_context::gizmo_context_impl & g, const rigid_transform_inverse & inverse, const int lod, const uint32_t set)
     {
-        gizmo_renderable r;
-        r.mesh = g.mesh_components[c].mesh;
-        r.color = (c == g.gizmos[id].interaction_mode) ? g.mesh_components[c].base_color : g.mesh_components[c].highlight_color;
-        for (auto & v : r.mesh.vertices)
+        static const float3 arms[3][2] = { { { 0,1,0 },{ 0,0,1 } },{ { 0,0,1 },{ 1,0,0 } },{ { 1,0,0 },{ 0,1,0 } } };
+        const uint32_t slices = 32 >> lod;
+        const float3 eye = inverse.detransform_vector(toward_viewer(g, inverse.position));
+        for (int i = 0; i < 3; ++i)
         {
-            v.position = transform_coord(modelMatrix, v.position); // transform local coordinates into worldspace
-            v.normal = transform_vector(modelMatrix, v.normal);
+            rings[i] = &g.mesh_components[interact(int(interact::rotate_x) + i)].mesh[lod];
+            lines[i] = &g.line_components[interact(int(interact::rotate_x) + i)][lod];
+            if (!g.active_state.trim_rotation_rings || !(set & (1u << i))) continue;
+
+            const float c1 = dot(eye, arms[i][0]), c2 = dot(eye, arms[i][1]);
+            if (c1 * c1 + c2 * c2 < 0.01f * length2(eye)) continue;
+
+            // Keep the slices whose centers lie within a quarter turn of the camera, plus one to cover the silhouette
+            const float slice_angle = tau / slices, phi = std::atan2(c2, c1) - tau / 8;
+            const int first = (int) std::ceil((phi - tau / 4) / slice_angle - 0.5f);
+            const uint32_t wrapped = (uint32_t) (((first % (int) slices) + (int) slices) % (int) slices);
+            const trimmed_ring_geometry & trimmed = trimmed_ring(g, i, lod, wrapped);
+            rings[i] = &trimmed.mesh;
+            lines[i] = &trimmed.lines;
+            variant |= (wrapped + 1) << (i * 8);
         }
-        g.drawlist.push_back(r);
     }
-}
+};
 
-void orientation_gizmo(const std::string & name, gizmo_context::gizmo_context_impl & g, const float3 & center, float4 & orientation)
+template<gizmo_space Space, uint32_t Components>
+void orientation_gizmo(const std::string & name, gizmo_context::gizmo_context_impl & g, const float3 & center, float4 & orientation, const uint32_t dynamic_set = 0)
 {
     assert(length2(orientation) > float(1e-6));
 
-    rigid_transform p = rigid_transform(g.local_toggle ? orientation : float4(0, 0, 0, 1), center); // Orientation is local by default
+    static const bool local = Space == gizmo_space::local;
+    const uint32_t set = handle_set<Components>(dynamic_set);
+    rigid_transform p = rigid_transform(local ? orientation : float4(0, 0, 0, 1), center);
+    const rigid_transform_inverse inverse(p);
     const float draw_scale = (g.active_state.screenspace_scale > 0.f) ? scale_screenspace(g, p.position, g.active_state.screenspace_scale) : 1.f;
     const uint32_t id = hash_fnv1a(name);
+    if (cull(g, id, p.position, draw_scale)) return;
+    const int lod = select_lod(g, id, p.position, draw_scale);
 
     // interaction_mode will only change on clicked
-    if (g.has_clicked) g.gizmos[id].interaction_mode = interact::none;
+    if (g.interactive && g.has_clicked) g.gizmos[id].interaction_mode = interact::none;
 
+    if (g.interactive)
     {
         interact updated_state = interact::none;
 
-        auto ray = detransform(p, { g.active_state.ray_origin, g.active_state.ray_direction });
+        auto ray = detransform(inverse, { g.active_state.ray_origin, g.active_state.ray_direction });
         detransform(draw_scale, ray);
-        float best_t = std::numeric_limits<float>::infinity(), t;
+        float best_t = std::numeric_limits<float>::infinity(), t = 0.f;
 
-        if (intersect(g, ray, interact::rotate_x, t, best_t)) { updated_state = interact::rotate_x; best_t = t; }
-        if (intersect(g, ray, interact::rotate_y, t, best_t)) { updated_state = interact::rotate_y; best_t = t; }
-        if (intersect(g, ray, interact::rotate_z, t, best_t)) { updated_state = interact::rotate_z; best_t = t; }
+        const trimmed_rings trimmed(g, inverse, lod, set);
+        if ((set & components::x) && intersect(g, ray, *trimmed.rings[0], *trimmed.lines[0], t, best_t)) { updated_state = interact::rotate_x; best_t = t; }
+        if ((set & components::y) && intersect(g, ray, *trimmed.rings[1], *trimmed.lines[1], t, best_t)) { updated_state = interact::rotate_y; best_t = t; }
+        if ((set & components::z) && intersect(g, ray, *trimmed.rings[2], *trimmed.lines[2], t, best_t)) { updated_state = interact::rotate_z; best_t = t; }
 
         if (g.has_clicked)
         {
@@ -584,13 +1961,18 @@ void orientation_gizmo(const std::string & name, gizmo_context::gizmo_context_im
     float3 activeAxis;
     if (g.gizmos[id].active)
     {
-        const float4 starting_orientation = g.local_toggle ? g.gizmos[id].original_orientation : float4(0, 0, 0, 1);
+        const float4 starting_orientation = local ? g.gizmos[id].original_orientation : float4(0, 0, 0, 1);
         switch (g.gizmos[id].interaction_mode)
         {
-        case interact::rotate_x: axis_rotation_dragger(id, g, { 1, 0, 0 }, center, starting_orientation, p.orientation); activeAxis = { 1, 0, 0 }; break;
-        case interact::rotate_y: axis_rotation_dragger(id, g, { 0, 1, 0 }, center, starting_orientation, p.orientation); activeAxis = { 0, 1, 0 }; break;
-        case interact::rotate_z: axis_rotation_dragger(id, g, { 0, 0, 1 }, center, starting_orientation, p.orientation); activeAxis = { 0, 0, 1 }; break;
+        case interact::rotate_x: activeAxis = { 1, 0, 0 }; break;
+        case interact::rotate_y: activeAxis = { 0, 1, 0 }; break;
+        case interact::rotate_z: activeAxis = { 0, 0, 1 }; break;
+        default: break;
         }
+
+        // Other viewports draw the rotation that the drag in the active viewport has already applied to `orientation`
+        if (g.interactive) axis_rotation_dragger(id, g, activeAxis, center, starting_orientation, p.orientation);
+        else if (!local) p.orientation = qmul(orientation, qinv(g.gizmos[id].original_orientation));
     }
 
     if (g.has_released)
@@ -603,28 +1985,28 @@ void orientation_gizmo(const std::string & name, gizmo_context::gizmo_context_im
     float4x4 scaleMatrix = scaling_matrix(float3(draw_scale));
     modelMatrix = mul(modelMatrix, scaleMatrix);
 
-    std::vector<interact> draw_interactions;
-    if (!g.local_toggle && g.gizmos[id].interaction_mode != interact::none) draw_interactions = { g.gizmos[id].interaction_mode };
-    else draw_interactions = { interact::rotate_x, interact::rotate_y, interact::rotate_z };
+    // A global rotation only draws the ring being dragged
+    const uint32_t drawn = (!local && g.gizmos[id].interaction_mode != interact::none) ? (1u << uint32_t(g.gizmos[id].interaction_mode)) >> uint32_t(interact::rotate_x) : set;
+    const std::vector<interact> & draw_interactions = select_components({ interact::rotate_x, interact::rotate_y, interact::rotate_z }, drawn, g.selected_components);
 
-    for (auto c : draw_interactions)
+    // The rotation arrow drawn for non-local transformations depends on the drag itself, so it is never cached
+    const bool draw_arrow = local == false && g.gizmos[id].interaction_mode != interact::none;
+    const trimmed_rings trimmed(g, rigid_transform_inverse(p), lod, set); // Recomputed since dragging may have changed the orientation
+    const geometry_mesh * meshes[3];
+    const geometry_lines * line_lists[3];
+    for (size_t i = 0; i < draw_interactions.size(); ++i)
     {
-        gizmo_renderable r;
-        r.mesh = g.mesh_components[c].mesh;
-        r.color = (c == g.gizmos[id].interaction_mode) ? g.mesh_components[c].base_color : g.mesh_components[c].highlight_color;
-        for (auto & v : r.mesh.vertices)
-        {
-            v.position = transform_coord(modelMatrix, v.position); // transform local coordinates into worldspace
-            v.normal = transform_vector(modelMatrix, v.normal);
-        }
-        g.drawlist.push_back(r);
+        meshes[i] = trimmed.rings[int(draw_interactions[i]) - int(interact::rotate_x)];
+        line_lists[i] = trimmed.lines[int(draw_interactions[i]) - int(interact::rotate_x)];
     }
+    emit(g, id, modelMatrix, draw_interactions, lod, draw_arrow, meshes, line_lists, trimmed.variant);
 
     // For non-local transformations, we only present one rotation ring 
     // and draw an arrow from the center of the gizmo to indicate the degree of rotation
-    if (g.local_toggle == false && g.gizmos[id].interaction_mode != interact::none)
+    if (draw_arrow)
     {
         interaction_state & interaction = g.gizmos[id];
+        gizmo_draw_cache & cache = g.draw_cache[(uint64_t(g.current_viewport) << 32) | id];
 
         // Create orthonormal basis for drawing the arrow
         float3 a = qrot(p.orientation, interaction.click_offset - interaction.original_position);
@@ -632,21 +2014,19 @@ void orientation_gizmo(const std::string & name, gizmo_context::gizmo_context_im
 
         // Ad-hoc geometry
         std::initializer_list<float2> arrow_points = { { 0.0f, 0.f },{ 0.0f, 0.05f },{ 0.8f, 0.05f },{ 0.9f, 0.10f },{ 1.0f, 0 } };
-        auto geo = make_lathed_geometry(yDir, xDir, zDir, 32, arrow_points);
-
-        gizmo_renderable r;
-        r.mesh = geo;
-        r.color = float4(1);
-        for (auto & v : r.mesh.vertices)
+        if (cache.triangles) // The arrow has no line or impostor representation
         {
-            v.position = transform_coord(modelMatrix, v.position);
-            v.normal = transform_vector(modelMatrix, v.normal);
+            gizmo_renderable r;
+            r.mesh = make_lathed_geometry(yDir, xDir, zDir, 32 >> lod, arrow_points);
+            r.color = float4(1);
+            r.component = interact::none; // Not a pickable component
+            g.kernels.transform_vertices(cache.output, modelMatrix, r.mesh.vertices);
+            cache.renderables.push_back(r);
         }
-        g.drawlist.push_back(r);
 
-        orientation = qmul(p.orientation, interaction.original_orientation);
+        if (g.interactive) orientation = qmul(p.orientation, interaction.original_orientation);
     }
-    else if (g.local_toggle == true && g.gizmos[id].interaction_mode != interact::none) orientation = p.orientation;
+    else if (g.interactive && local == true && g.gizmos[id].interaction_mode != interact::none) orientation = p.orientation;
 }
 
 void axis_scale_dragger(const uint32_t & id, gizmo_context::gizmo_context_impl & g, const float3 & axis, const float3 & center, float3 & scale, const bool uniform)
@@ -655,7 +2035,7 @@ void axis_scale_dragger(const uint32_t & id, gizmo_context::gizmo_context_impl &
 
     if (g.active_state.mouse_left)
     {
-        const float3 plane_tangent = cross(axis, center - g.active_state.cam.position);
+        const float3 plane_tangent = cross(axis, -toward_viewer(g, center));
         const float3 plane_normal = cross(axis, plane_tangent);
 
         float3 distance;
@@ -685,22 +2065,29 @@ void axis_scale_dragger(const uint32_t & id, gizmo_context::gizmo_context_impl &
     }
 }
 
-void scale_gizmo(const std::string & name, gizmo_context::gizmo_context_impl & g, const float4 & orientation, const float3 & center, float3 & scale)
+template<uint32_t Components>
+void scale_gizmo(const std::string & name, gizmo_context::gizmo_context_impl & g, const float4 & orientation, const float3 & center, float3 & scale, const uint32_t dynamic_set = 0)
 {
+    const uint32_t set = handle_set<Components>(dynamic_set);
     rigid_transform p = rigid_transform(orientation, center);
+    const rigid_transform_inverse inverse(p);
     const float draw_scale = (g.active_state.screenspace_scale > 0.f) ? scale_screenspace(g, p.position, g.active_state.screenspace_scale) : 1.f;
     const uint32_t id = hash_fnv1a(name);
+    if (cull(g, id, p.position, draw_scale)) return;
+    const int lod = select_lod(g, id, p.position, draw_scale);
+    hide_degenerate_components(g, id, inverse);
 
-    if (g.has_clicked) g.gizmos[id].interaction_mode = interact::none;
+    if (g.interactive && g.has_clicked) g.gizmos[id].interaction_mode = interact::none;
 
+    if (g.interactive)
     {
         interact updated_state = interact::none;
-        auto ray = detransform(p, { g.active_state.ray_origin, g.active_state.ray_direction });
+        auto ray = detransform(inverse, { g.active_state.ray_origin, g.active_state.ray_direction });
         detransform(draw_scale, ray);
-        float best_t = std::numeric_limits<float>::infinity(), t;
-        if (intersect(g, ray, interact::scale_x, t, best_t)) { updated_state = interact::scale_x; best_t = t; }
-        if (intersect(g, ray, interact::scale_y, t, best_t)) { updated_state = interact::scale_y; best_t = t; }
-        if (intersect(g, ray, interact::scale_z, t, best_t)) { updated_state = interact::scale_z; best_t = t; }
+        float best_t = std::numeric_limits<float>::infinity(), t = 0.f;
+        if ((set & components::x) && intersect(g, ray, id, interact::scale_x, t, best_t)) { updated_state = interact::scale_x; best_t = t; }
+        if ((set & components::y) && intersect(g, ray, id, interact::scale_y, t, best_t)) { updated_state = interact::scale_y; best_t = t; }
+        if ((set & components::z) && intersect(g, ray, id, interact::scale_z, t, best_t)) { updated_state = interact::scale_z; best_t = t; }
 
         if (g.has_clicked)
         {
@@ -722,13 +2109,14 @@ void scale_gizmo(const std::string & name, gizmo_context::gizmo_context_impl & g
         g.gizmos[id].active = false;
     }
 
-    if (g.gizmos[id].active)
+    if (g.interactive && g.gizmos[id].active)
     {
         switch (g.gizmos[id].interaction_mode)
         {
         case interact::scale_x: axis_scale_dragger(id, g, { 1,0,0 }, center, scale, g.active_state.hotkey_ctrl); break;
         case interact::scale_y: axis_scale_dragger(id, g, { 0,1,0 }, center, scale, g.active_state.hotkey_ctrl); break;
         case interact::scale_z: axis_scale_dragger(id, g, { 0,0,1 }, center, scale, g.active_state.hotkey_ctrl); break;
+        default: break;
         }
     }
 
@@ -736,49 +2124,206 @@ void scale_gizmo(const std::string & name, gizmo_context::gizmo_context_impl & g
     float4x4 scaleMatrix = scaling_matrix(float3(draw_scale));
     modelMatrix = mul(modelMatrix, scaleMatrix);
 
-    std::vector<interact> draw_components { interact::scale_x, interact::scale_y, interact::scale_z };
+    const std::vector<interact> & draw_components = select_components({ interact::scale_x, interact::scale_y, interact::scale_z }, set, g.selected_components);
 
-    for (auto c : draw_components)
-    {
-        gizmo_renderable r;
-        r.mesh = g.mesh_components[c].mesh;
-        r.color = (c == g.gizmos[id].interaction_mode) ? g.mesh_components[c].base_color : g.mesh_components[c].highlight_color;
-        for (auto & v : r.mesh.vertices)
-        {
-            v.position = transform_coord(modelMatrix, v.position); // transform local coordinates into worldspace
-            v.normal = transform_vector(modelMatrix, v.normal);
-        }
-        g.drawlist.push_back(r);
-    }
+    emit(g, id, modelMatrix, draw_components, lod, false);
 }
 
 //////////////////////////////////
 // Public Gizmo Implementations //
 //////////////////////////////////
 
-gizmo_context::gizmo_context() { impl.reset(new gizmo_context_impl(this)); };
+template<class Convention> gizmo_context::gizmo_context(cpu_tier max_tier, Convention) { impl.reset(new gizmo_context_impl(this)); impl->kernels = select_kernels(max_tier); };
+template gizmo_context::gizmo_context(cpu_tier, convention); // Only for the convention of this build, see TINYGIZMO_CONVENTION
 gizmo_context::~gizmo_context() { }
 void gizmo_context::update(const gizmo_application_state & state) { impl->update(state); }
+void gizmo_context::update(const gizmo_application_state & state, const std::vector<gizmo_viewport> & viewports) { impl->update(state, viewports); }
+uint32_t gizmo_context::get_active_viewport() const { return impl->active_viewport; }
 void gizmo_context::draw() { impl->draw(); }
 transform_mode gizmo_context::get_mode() const { return impl->mode; }
+uint64_t gizmo_context::get_generation() const { return impl->generation; }
+const std::vector<geometry_range> & gizmo_context::get_dirty_ranges() const { return impl->dirty_ranges; }
+const gizmo_stats & gizmo_context::get_stats() const { return impl->stats; }
+cpu_tier gizmo_context::get_cpu_tier() const { return impl->kernels.tier; }
 
-bool tinygizmo::transform_gizmo(const std::string & name, gizmo_context & g, rigid_transform & t)
+///////////////////////////////////
+//   Impostor Reference Evaluator  //
+///////////////////////////////////
+
+// Signed distance to a capped cone along y, centered on the origin with half height h, radius r1 at -h and r2 at +h
+static float sd_capped_cone(const float2 & q, float h, float r1, float r2)
 {
-    bool activated = false;
+    const float2 k1 = { r2, h }, k2 = { r2 - r1, 2 * h };
+    const float2 ca = { q.x - std::min(q.x, (q.y < 0) ? r1 : r2), std::abs(q.y) - h };
+    const float2 cb = q - k1 + k2 * clamp(dot(k1 - q, k2) / length2(k2), 0.f, 1.f);
+    const float s = (cb.x < 0 && ca.y < 0) ? -1.f : 1.f;
+    return s * std::sqrt(std::min(length2(ca), length2(cb)));
+}
 
-    if (g.impl->active_state.hotkey_ctrl == true)
+// Signed distance to a 2d box centered on the origin
+static float sd_box(const float2 & q, const float2 & half_extents)
+{
+    const float2 d = abs(q) - half_extents;
+    return length(max(d, float2(0.f))) + std::min(std::max(d.x, d.y), 0.f);
+}
+
+static float sd_box(const float3 & q, const float3 & half_extents)
+{
+    const float3 d = abs(q) - half_extents;
+    return length(max(d, float3(0.f))) + std::min(std::max(d.x, std::max(d.y, d.z)), 0.f);
+}
+
+float tinygizmo::gizmo_impostor_distance(const gizmo_impostor & i, const float3 & point)
+{
+    const float3 p = qrot(qconj(i.orientation), point - i.origin) / i.scale;
+
+    // Cylindrical coordinates around an axis: (distance from the axis, position along the axis)
+    auto around = [&](const float3 & axis) { const float h = dot(p, axis); return float2(length(p - axis * h), h); };
+
+    float d = 0;
+    switch (i.shape)
     {
-        if (g.impl->last_state.hotkey_translate == false && g.impl->active_state.hotkey_translate == true) g.impl->mode = transform_mode::translate;
-        else if (g.impl->last_state.hotkey_rotate == false && g.impl->active_state.hotkey_rotate == true) g.impl->mode = transform_mode::rotate;
-        else if (g.impl->last_state.hotkey_scale == false && g.impl->active_state.hotkey_scale == true) g.impl->mode = transform_mode::scale;
+    case impostor_shape::arrow:
+    case impostor_shape::mace:
+    {
+        const impostor_shaft & s = i.shaft;
+        const float2 q = around(s.axis);
+        const float shaft = sd_box(q - float2(0, (s.start + s.end) / 2), float2(s.radius, (s.end - s.start) / 2));
+        const float2 head_center = q - float2(0, s.end + s.head_length / 2);
+        const float head = (i.shape == impostor_shape::arrow) ? sd_capped_cone(head_center, s.head_length / 2, s.head_radius, 0)
+                                                             : sd_box(head_center, float2(s.head_radius, s.head_length / 2));
+        d = std::min(shaft, head);
+        break;
+    }
+    case impostor_shape::ring:
+    {
+        const float2 q = around(i.ring.axis);
+        d = sd_box(float2(q.x - i.ring.radius, q.y), float2(i.ring.half_width, i.ring.half_thickness));
+        break;
+    }
+    case impostor_shape::box: d = sd_box(p - i.box.center, i.box.half_extents); break;
     }
+    return d * i.scale;
+}
 
-    if (g.impl->mode == transform_mode::translate) position_gizmo(name, *g.impl, t.orientation, t.position);
-    else if (g.impl->mode == transform_mode::rotate) orientation_gizmo(name, *g.impl, t.position, t.orientation);
-    else if (g.impl->mode == transform_mode::scale) scale_gizmo(name, *g.impl, t.orientation, t.position, t.scale);
+void tinygizmo::gizmo_impostor_bounds(const gizmo_impostor & i, float3 & center, float & radius)
+{
+    center = float3(0.f);
+    radius = 0.f;
+    switch (i.shape)
+    {
+    case impostor_shape::arrow:
+    case impostor_shape::mace:
+        center = i.shaft.axis * ((i.shaft.start + i.shaft.end + i.shaft.head_length) / 2);
+        radius = length(float2((i.shaft.end + i.shaft.head_length - i.shaft.start) / 2, std::max(i.shaft.radius, i.shaft.head_radius)));
+        break;
+    case impostor_shape::ring: radius = length(float2(i.ring.radius + i.ring.half_width, i.ring.half_thickness)); break;
+    case impostor_shape::box: center = i.box.center; radius = length(i.box.half_extents); break;
+    }
+    center = i.origin + qrot(i.orientation, center * i.scale);
+    radius *= i.scale;
+}
+
+bool tinygizmo::intersect_gizmo_impostor(const gizmo_impostor & impostor, const float3 & ray_origin, const float3 & ray_direction, float * hit_t)
+{
+    const float3 dir = normalize(ray_direction);
+
+    // March through the bounding sphere, which the quad a fragment shader runs on covers
+    float3 center; float radius;
+    gizmo_impostor_bounds(impostor, center, radius);
+    const float mid = dot(center - ray_origin, dir);
+    float t = std::max(0.f, mid - radius);
+
+    for (int step = 0; step < 128 && t < mid + radius; ++step)
+    {
+        const float d = gizmo_impostor_distance(impostor, ray_origin + dir * t);
+        if (d < 1e-4f * impostor.scale)
+        {
+            if (hit_t) *hit_t = t / length(ray_direction);
+            return true;
+        }
+        t += d;
+    }
+    return false;
+}
+
+// Run a gizmo once per viewport. Picking and dragging happen in the active viewport, which goes last so that `active_state` is
+// left as it was. The others only emit geometry, for the same transform the active viewport starts from.
+template<class F> bool run_gizmo(const std::string & name, gizmo_context & g, F gizmo)
+{
+    bool activated = false;
+
+    const uint32_t viewport_count = std::max<uint32_t>((uint32_t) g.impl->viewports.size(), 1);
+    for (uint32_t i = 1; i <= viewport_count; ++i)
+    {
+        const uint32_t viewport = (g.impl->active_viewport + i) % viewport_count;
+        if (viewport_count > 1) g.impl->use_viewport(viewport);
+        gizmo(*g.impl);
+    }
 
     const interaction_state s = g.impl->gizmos[hash_fnv1a(name)];
     if (s.hover == true || s.active == true) activated = true;
 
     return activated;
+}
+
+// The default set of handles of each gizmo runs its specialization, and any other set the one with `dynamic_components`
+bool tinygizmo::translate_gizmo(const std::string & name, gizmo_context & g, rigid_transform & t, gizmo_space space, uint32_t set)
+{
+    set &= components::all;
+    return run_gizmo(name, g, [&](gizmo_context::gizmo_context_impl & impl)
+    {
+        if (space == gizmo_space::local)
+        {
+            if (set == components::all) position_gizmo<gizmo_space::local, components::all>(name, impl, t.orientation, t.position);
+            else position_gizmo<gizmo_space::local, dynamic_components>(name, impl, t.orientation, t.position, set);
+        }
+        else if (set == components::all) position_gizmo<gizmo_space::global, components::all>(name, impl, t.orientation, t.position);
+        else position_gizmo<gizmo_space::global, dynamic_components>(name, impl, t.orientation, t.position, set);
+    });
+}
+
+bool tinygizmo::rotate_gizmo(const std::string & name, gizmo_context & g, rigid_transform & t, gizmo_space space, uint32_t set)
+{
+    set &= components::axes;
+    return run_gizmo(name, g, [&](gizmo_context::gizmo_context_impl & impl)
+    {
+        if (space == gizmo_space::local)
+        {
+            if (set == components::axes) orientation_gizmo<gizmo_space::local, components::axes>(name, impl, t.position, t.orientation);
+            else orientation_gizmo<gizmo_space::local, dynamic_components>(name, impl, t.position, t.orientation, set);
+        }
+        else if (set == components::axes) orientation_gizmo<gizmo_space::global, components::axes>(name, impl, t.position, t.orientation);
+        else orientation_gizmo<gizmo_space::global, dynamic_components>(name, impl, t.position, t.orientation, set);
+    });
+}
+
+bool tinygizmo::scale_gizmo(const std::string & name, gizmo_context & g, rigid_transform & t, uint32_t set)
+{
+    set &= components::axes;
+    return run_gizmo(name, g, [&](gizmo_context::gizmo_context_impl & impl)
+    {
+        if (set == components::axes) ::scale_gizmo<components::axes>(name, impl, t.orientation, t.position, t.scale);
+        else ::scale_gizmo<dynamic_components>(name, impl, t.orientation, t.position, t.scale, set);
+    });
+}
+
+// The runtime API dispatches to the specializations with every handle
+bool tinygizmo::transform_gizmo(const std::string & name, gizmo_context & g, rigid_transform & t)
+{
+    if (g.impl->active_state.hotkey_ctrl == true)
+    {
+        if (g.impl->last_state.hotkey_translate == false && g.impl->active_state.hotkey_translate == true) g.impl->mode = transform_mode::translate;
+        else if (g.impl->last_state.hotkey_rotate == false && g.impl->active_state.hotkey_rotate == true) g.impl->mode = transform_mode::rotate;
+        else if (g.impl->last_state.hotkey_scale == false && g.impl->active_state.hotkey_scale == true) g.impl->mode = transform_mode::scale;
+    }
+
+    const bool local = g.impl->local_toggle;
+    switch (g.impl->mode)
+    {
+    case transform_mode::translate: return translate_gizmo(name, g, t, local ? gizmo_space::local : gizmo_space::global);
+    case transform_mode::rotate: return rotate_gizmo(name, g, t, local ? gizmo_space::local : gizmo_space::global);
+    case transform_mode::scale: return scale_gizmo(name, g, t);
+    }
+    return false;
 }
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include <functional>   // For std::function callbacks
 #include <memory>       // For std::unique_ptr
 #include <vector>       // For ... 
+#include <type_traits> // For the layout checks of the user math adapters
 #include <ostream>      // For overloads of operator<< to std::ostream& in the operator<< overloads provided by this library
 
 // Visual Studio versions prior to 2015 lack constexpr support
@@ -20,6 +21,20 @@
     #define constexpr
 #endif
 
+// Define TINYGIZMO_SIMD to replace the hottest float4/float4x4 operations with SSE or NEON versions. AVX builds
+// use the SSE path (VEX-encoded by the compiler). The scalar templates remain the default and the reference.
+#if defined(TINYGIZMO_SIMD)
+    #if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #include <xmmintrin.h>
+        #define TINYGIZMO_SIMD_SSE
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+        #include <arm_neon.h>
+        #define TINYGIZMO_SIMD_NEON
+    #else
+        #error "TINYGIZMO_SIMD requires a target with SSE2 or NEON"
+    #endif
+#endif
+
 // This library includes an inline version of linalg.h (https://github.com/sgorsten/linalg) in a separate minalg
 // namespace. This is to reduce the number of files in this library to 2, without a separate header specifically
 // for 3d math. 
@@ -336,6 +351,7 @@ namespace minalg
     template<class T> T determinant(const mat<T, 3, 3> & a) { return a.x.x*(a.y.y*a.z.z - a.z.y*a.y.z) + a.x.y*(a.y.z*a.z.x - a.z.z*a.y.x) + a.x.z*(a.y.x*a.z.y - a.z.x*a.y.y); }
     template<class T> T determinant(const mat<T, 4, 4> & a);
     template<class T, int N> mat<T, N, N> inverse(const mat<T, N, N> & a) { return adjugate(a) / determinant(a); }
+    template<class T> mat<T, 4, 4> inverse_rigid(const mat<T, 4, 4> & a) { const mat<T, 3, 3> r = transpose(mat<T, 3, 3>{ a.x.xyz(), a.y.xyz(), a.z.xyz() }); return{ { r.x,0 },{ r.y,0 },{ r.z,0 },{ -mul(r, a.w.xyz()),1 } }; } // Rotation and translation only
 
     // Vectors and matrices can be used as ranges
     template<class T, int M>       T * begin(vec<T, M> & a) { return &a[0]; }
@@ -357,6 +373,7 @@ namespace minalg
     template<class T> mat<T, 4, 4> scaling_matrix(const vec<T, 3> & scaling) { return{ { scaling.x,0,0,0 },{ 0,scaling.y,0,0 },{ 0,0,scaling.z,0 },{ 0,0,0,1 } }; }
     template<class T> mat<T, 4, 4> pose_matrix(const vec<T, 4> & q, const vec<T, 3> & p) { return{ { qxdir(q),0 },{ qydir(q),0 },{ qzdir(q),0 },{ p,1 } }; }
     template<class T> mat<T, 4, 4> frustum_matrix(T x0, T x1, T y0, T y1, T n, T f, fwd_axis a = neg_z, z_range z = neg_one_to_one) { const T s = a == pos_z ? T(1) : T(-1); return z == zero_to_one ? mat<T, 4, 4>{ {2 * n / (x1 - x0), 0, 0, 0}, { 0,2 * n / (y1 - y0),0,0 }, { (x0 + x1) / (x1 - x0),(y0 + y1) / (y1 - y0),s*(f + 0) / (f - n),s }, { 0,0,-1 * n*f / (f - n),0 }} : mat<T, 4, 4>{ { 2 * n / (x1 - x0),0,0,0 },{ 0,2 * n / (y1 - y0),0,0 },{ (x0 + x1) / (x1 - x0),(y0 + y1) / (y1 - y0),s*(f + n) / (f - n),s },{ 0,0,-2 * n*f / (f - n),0 } }; }
+    template<class T> mat<T, 4, 4> orthographic_matrix(T x0, T x1, T y0, T y1, T n, T f, fwd_axis a = neg_z, z_range z = neg_one_to_one) { const T s = a == pos_z ? T(1) : T(-1); return z == zero_to_one ? mat<T, 4, 4>{ { 2 / (x1 - x0),0,0,0 },{ 0,2 / (y1 - y0),0,0 },{ 0,0,s / (f - n),0 },{ -(x0 + x1) / (x1 - x0),-(y0 + y1) / (y1 - y0),-n / (f - n),1 } } : mat<T, 4, 4>{ { 2 / (x1 - x0),0,0,0 },{ 0,2 / (y1 - y0),0,0 },{ 0,0,s * 2 / (f - n),0 },{ -(x0 + x1) / (x1 - x0),-(y0 + y1) / (y1 - y0),-(f + n) / (f - n),1 } }; }
     template<class T> mat<T, 4, 4> perspective_matrix(T fovy, T aspect, T n, T f, fwd_axis a = neg_z, z_range z = neg_one_to_one) { T y = n*std::tan(fovy / 2), x = y*aspect; return frustum_matrix(-x, x, -y, y, n, f, a, z); }
 
     // Provide typedefs for common element types and vector/matrix sizes
@@ -407,6 +424,105 @@ template<class T> T minalg::determinant(const mat<T, 4, 4> & a)
         + a.x.w*(a.y.x*a.w.y*a.z.z + a.z.x*a.y.y*a.w.z + a.w.x*a.z.y*a.y.z - a.y.x*a.z.y*a.w.z - a.w.x*a.y.y*a.z.z - a.z.x*a.w.y*a.y.z);
 }
 
+#if defined(TINYGIZMO_SIMD)
+
+// Four-lane float abstraction shared by the SSE and NEON backends. Only what the overloads below need is provided.
+namespace minalg
+{
+    namespace simd
+    {
+#if defined(TINYGIZMO_SIMD_SSE)
+        typedef __m128 f32x4;
+        inline f32x4 load(const vec<float, 4> & v) { return _mm_loadu_ps(&v.x); }
+        inline f32x4 load(const vec<float, 3> & v) { return _mm_setr_ps(v.x, v.y, v.z, 0); }
+        inline vec<float, 4> store4(f32x4 v) { vec<float, 4> r; _mm_storeu_ps(&r.x, v); return r; }
+        inline f32x4 splat(float s) { return _mm_set1_ps(s); }
+        inline f32x4 set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+        inline f32x4 add(f32x4 a, f32x4 b) { return _mm_add_ps(a, b); }
+        inline f32x4 sub(f32x4 a, f32x4 b) { return _mm_sub_ps(a, b); }
+        inline f32x4 mul(f32x4 a, f32x4 b) { return _mm_mul_ps(a, b); }
+        template<int A, int B, int C, int D> f32x4 swizzle(f32x4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(D, C, B, A)); }
+#else
+        typedef float32x4_t f32x4;
+        inline f32x4 load(const vec<float, 4> & v) { return vld1q_f32(&v.x); }
+        inline f32x4 load(const vec<float, 3> & v) { const float p[4] = { v.x, v.y, v.z, 0 }; return vld1q_f32(p); }
+        inline vec<float, 4> store4(f32x4 v) { vec<float, 4> r; vst1q_f32(&r.x, v); return r; }
+        inline f32x4 splat(float s) { return vdupq_n_f32(s); }
+        inline f32x4 set(float x, float y, float z, float w) { const float p[4] = { x, y, z, w }; return vld1q_f32(p); }
+        inline f32x4 add(f32x4 a, f32x4 b) { return vaddq_f32(a, b); }
+        inline f32x4 sub(f32x4 a, f32x4 b) { return vsubq_f32(a, b); }
+        inline f32x4 mul(f32x4 a, f32x4 b) { return vmulq_f32(a, b); }
+        template<int A, int B, int C, int D> f32x4 swizzle(f32x4 v) { const float p[4] = { vgetq_lane_f32(v, A), vgetq_lane_f32(v, B), vgetq_lane_f32(v, C), vgetq_lane_f32(v, D) }; return vld1q_f32(p); }
+#endif
+        template<int I> f32x4 lane(f32x4 v) { return swizzle<I, I, I, I>(v); }
+        inline f32x4 madd(f32x4 a, f32x4 b, f32x4 c) { return add(mul(a, b), c); }
+        inline vec<float, 3> store3(f32x4 v) { const vec<float, 4> r = store4(v); return{ r.x, r.y, r.z }; }
+        inline f32x4 cross3(f32x4 a, f32x4 b) { return sub(mul(swizzle<1, 2, 0, 3>(a), swizzle<2, 0, 1, 3>(b)), mul(swizzle<2, 0, 1, 3>(a), swizzle<1, 2, 0, 3>(b))); }
+        inline float dot3(f32x4 a, f32x4 b) { const vec<float, 4> p = store4(mul(a, b)); return p.x + p.y + p.z; }
+        inline f32x4 mul(const mat<float, 4, 4> & a, f32x4 b)
+        {
+            f32x4 r = mul(load(a.x), lane<0>(b));
+            r = madd(load(a.y), lane<1>(b), r);
+            r = madd(load(a.z), lane<2>(b), r);
+            return madd(load(a.w), lane<3>(b), r);
+        }
+    }
+
+    // Non-template overloads are preferred over the generic templates above for exact float arguments
+    inline vec<float, 4> qmul(const vec<float, 4> & a, const vec<float, 4> & b)
+    {
+        using namespace simd;
+        const f32x4 va = load(a), vb = load(b);
+        f32x4 r = mul(lane<3>(va), vb);
+        r = madd(mul(lane<0>(va), swizzle<3, 2, 1, 0>(vb)), set(1, -1, 1, -1), r);
+        r = madd(mul(lane<1>(va), swizzle<2, 3, 0, 1>(vb)), set(1, 1, -1, -1), r);
+        r = madd(mul(lane<2>(va), swizzle<1, 0, 3, 2>(vb)), set(-1, 1, 1, -1), r);
+        return store4(r);
+    }
+
+    // Expands q*v*conj(q) as (w^2 - |u|^2) v + 2 (u.v) u + 2 w (u x v), which matches the scalar path for non-unit q
+    inline vec<float, 3> qrot(const vec<float, 4> & q, const vec<float, 3> & v)
+    {
+        using namespace simd;
+        const f32x4 u = load(q.xyz()), vv = load(v);
+        f32x4 r = mul(vv, splat(q.w * q.w - dot3(u, u)));
+        r = madd(u, splat(2 * dot3(u, vv)), r);
+        r = madd(cross3(u, vv), splat(2 * q.w), r);
+        return store3(r);
+    }
+
+    inline vec<float, 4> mul(const mat<float, 4, 4> & a, const vec<float, 4> & b)
+    {
+        return simd::store4(simd::mul(a, simd::load(b)));
+    }
+
+    inline mat<float, 4, 4> mul(const mat<float, 4, 4> & a, const mat<float, 4, 4> & b)
+    {
+        using namespace simd;
+        return{ store4(simd::mul(a, load(b.x))), store4(simd::mul(a, load(b.y))), store4(simd::mul(a, load(b.z))), store4(simd::mul(a, load(b.w))) };
+    }
+
+    // Cofactor expansion over pairs of columns (see Lengyel, Foundations of Game Engine Development, vol. 1). The
+    // result rows are built in registers and transposed on the way out. Singular input yields non-finite values, as
+    // with the scalar path.
+    inline mat<float, 4, 4> inverse(const mat<float, 4, 4> & m)
+    {
+        using namespace simd;
+        const f32x4 a = load(m.x), b = load(m.y), c = load(m.z), d = load(m.w);
+        const f32x4 x = lane<3>(a), y = lane<3>(b), z = lane<3>(c), w = lane<3>(d);
+        f32x4 s = cross3(a, b), t = cross3(c, d);
+        f32x4 u = sub(mul(a, y), mul(b, x)), v = sub(mul(c, w), mul(d, z));
+        const f32x4 inv_det = splat(1.0f / (dot3(s, v) + dot3(t, u)));
+        s = mul(s, inv_det); t = mul(t, inv_det); u = mul(u, inv_det); v = mul(v, inv_det);
+        const vec<float, 3> r0 = store3(madd(t, y, cross3(b, v))), r1 = store3(sub(cross3(v, a), mul(t, x)));
+        const vec<float, 3> r2 = store3(madd(s, w, cross3(d, u))), r3 = store3(sub(cross3(u, c), mul(s, z)));
+        const float w0 = -dot3(b, t), w1 = dot3(a, t), w2 = -dot3(d, s), w3 = dot3(c, s);
+        return{ { r0.x, r1.x, r2.x, r3.x }, { r0.y, r1.y, r2.y, r3.y }, { r0.z, r1.z, r2.z, r3.z }, { w0, w1, w2, w3 } };
+    }
+} // end namespace minalg
+
+#endif // TINYGIZMO_SIMD
+
 //////////////////////////
 //   Linalg Utilities   //
 //////////////////////////
@@ -443,6 +559,20 @@ namespace tinygizmo
         minalg::float3      detransform_vector(const minalg::float3 & vec) const { return qrot(qinv(orientation), vec) / scale; }
     };
 
+    // Inverse of a rigid_transform, with qinv(orientation) and the reciprocal scale computed once for detransforming many points
+    struct rigid_transform_inverse
+    {
+        rigid_transform_inverse(const rigid_transform & t) : position(t.position), orientation(qinv(t.orientation)), scale(1.f / t.scale) {}
+
+        minalg::float3      position;       // Of the original transform
+        minalg::float4      orientation;    // qinv of the original orientation
+        minalg::float3      scale;          // Reciprocal of the original scale
+
+        minalg::float4x4    matrix() const { return mul(scaling_matrix(scale), rotation_matrix(orientation), translation_matrix(-position)); }
+        minalg::float3      detransform_vector(const minalg::float3 & vec) const { return qrot(orientation, vec) * scale; }
+        minalg::float3      detransform_point(const minalg::float3 & p) const { return detransform_vector(p - position); }
+    };
+
     static const float EPSILON = 0.001f;
     inline bool fuzzy_equality(float a, float b, float eps = EPSILON) { return std::abs(a - b) < eps; }
     inline bool fuzzy_equality(minalg::float3 a, minalg::float3 b, float eps = EPSILON) { return fuzzy_equality(a.x, b.x) && fuzzy_equality(a.y, b.y) && fuzzy_equality(a.z, b.z); }
@@ -452,15 +582,62 @@ namespace tinygizmo
         return (!fuzzy_equality(a.position, b.position) || !fuzzy_equality(a.orientation, b.orientation) || !fuzzy_equality(a.scale, b.scale));
     }
 
+    // Coordinate conventions. The gizmos are built along the x, y and z axes of the transform being edited, so only the camera
+    // frame depends on a convention: `Up` and `Forward` are axes of the camera's local frame (+Y and -Z for OpenGL, +Z and +X
+    // for many Z-up engines) and `Depth` is the NDC depth range of ndc and screen output. A build selects one convention by
+    // defining TINYGIZMO_CONVENTION to one of these types before every include of this header, so that the camera axes fold
+    // into constants. Mirrored conventions also mirror the emitted triangles, which are then clockwise seen from the front.
+    // The constructors of `gizmo_context` pass the convention of the including file to the library, which only defines them for
+    // its own: a file that includes this header with a different convention fails to link, naming the convention it asked for.
+    enum class handedness { right, left };
+    enum class axis { pos_x, neg_x, pos_y, neg_y, pos_z, neg_z };
+    constexpr int axis_index(axis a) { return static_cast<int>(a) / 2; }
+    constexpr float axis_sign(axis a) { return static_cast<int>(a) % 2 ? -1.f : 1.f; }
+    constexpr axis axis_cross(axis a, axis b) { return static_cast<axis>(2 * (3 - axis_index(a) - axis_index(b)) + ((axis_sign(a) * axis_sign(b) > 0) != ((axis_index(b) - axis_index(a) + 3) % 3 == 1))); }
+
+    template<handedness Hand, axis Up, axis Forward, minalg::z_range Depth> struct coordinate_convention
+    {
+        static_assert(axis_index(Up) != axis_index(Forward), "the up and forward axes of the camera must be perpendicular");
+        static const handedness hand = Hand;
+        static const axis up = Up, forward = Forward, right = Hand == handedness::right ? axis_cross(Forward, Up) : axis_cross(Up, Forward);
+        static const minalg::z_range depth = Depth;
+    };
+
+    namespace conventions
+    {
+        typedef coordinate_convention<handedness::right, axis::pos_y, axis::neg_z, minalg::neg_one_to_one> right_handed_y_up; // OpenGL; the default
+        typedef coordinate_convention<handedness::left, axis::pos_y, axis::pos_z, minalg::zero_to_one> left_handed_y_up;      // Direct3D
+        typedef coordinate_convention<handedness::right, axis::pos_z, axis::pos_x, minalg::zero_to_one> right_handed_z_up;    // Right is -Y
+        typedef coordinate_convention<handedness::left, axis::pos_z, axis::pos_x, minalg::zero_to_one> left_handed_z_up;      // Right is +Y
+    }
+
+#if !defined(TINYGIZMO_CONVENTION)
+    #define TINYGIZMO_CONVENTION tinygizmo::conventions::right_handed_y_up
+#endif
+    typedef TINYGIZMO_CONVENTION convention;
+
     struct camera_parameters
     {
         float yfov, near_clip, far_clip;
         minalg::float3 position;
         minalg::float4 orientation;
+        bool orthographic{ false };         // If true, the projection is parallel and `yfov` is unused. Pick rays are then parallel to the view direction
+        float ortho_height{ 0.f };          // World-space height of the view volume of an orthographic camera
     };
 
+    enum class geometry_space { world, ndc, screen };      // Space of emitted vertex positions; screen is in pixels with y down and NDC depth
     struct geometry_vertex { minalg::float3 position, normal; minalg::float4 color; };
     struct geometry_mesh { std::vector<geometry_vertex> vertices; std::vector<minalg::uint3> triangles; };
+    // Chunk N passed to `render_chunk` stays valid until the callback for chunk N+1 returns, after which its buffer is reused for
+    // chunk N+2. Chunking bounds only the output buffers: the context still retains the geometry of every gizmo drawn this frame, so
+    // total memory remains proportional to the whole merged mesh.
+    struct geometry_chunk { std::vector<geometry_vertex> vertices; std::vector<minalg::ushort3> triangles; };
+    struct geometry_range { uint32_t vertex_offset, vertex_count, triangle_offset, triangle_count; };
+    struct geometry_streams { std::vector<minalg::float3> positions, normals; std::vector<minalg::float4> colors; std::vector<minalg::uint3> triangles; };
+    struct geometry_lines { std::vector<geometry_vertex> vertices; std::vector<minalg::uint2> lines; }; // Line list; vertex normals are unused
+
+    void optimize_geometry(geometry_mesh & mesh, uint32_t cache_size = 16);        // Reorder triangles for the post-transform vertex cache (Tipsify), then vertices by first use. Unreferenced vertices are removed
+    float compute_acmr(const geometry_mesh & mesh, uint32_t cache_size = 16);      // Average vertices transformed per triangle, simulating a FIFO post-transform cache
 
     ///////////////
     //   Gizmo   //
@@ -473,6 +650,65 @@ namespace tinygizmo
         scale
     };
 
+    enum class interact
+    {
+        none,
+        translate_x, translate_y, translate_z,
+        translate_yz, translate_zx, translate_xy,
+        translate_xyz,
+        rotate_x, rotate_y, rotate_z,
+        scale_x, scale_y, scale_z,
+        scale_xyz,
+    };
+
+    // Non-owning view of a single gizmo component, passed to `render_component`. The per-vertex color attribute is not
+    // filled on this path; the component color is provided once instead.
+    struct geometry_view
+    {
+        const geometry_vertex * vertices;
+        uint32_t vertex_count;
+        const minalg::uint3 * triangles;
+        uint32_t triangle_count;
+        minalg::float4 color;
+        interact component;                 // Component this geometry belongs to, or `interact::none` for decorations such as the rotation arrow
+        uint32_t gizmo_id;                  // Hash of the name passed to `transform_gizmo(...)`
+    };
+
+    // Analytic description of a single gizmo component, passed to `render_impostors`. The component is rasterized as a
+    // camera-facing quad covering `gizmo_impostor_bounds(...)`, whose fragments evaluate the signed distance function given by
+    // `gizmo_impostor_distance(...)`. Shape parameters are in gizmo units; a gizmo-space point maps to
+    // `origin + qrot(orientation, point * scale)`. Only the member named after `shape` is meaningful (`shaft` for arrows and maces).
+    enum class impostor_shape { arrow, mace, ring, box };
+    struct impostor_shaft                   // A cylinder from `start` to `end` along `axis`, capped by a cone (arrow) or cylinder (mace) head
+    {
+        minalg::float3 axis;                // Unit axis
+        float start, end, radius;
+        float head_length, head_radius;
+    };
+    struct impostor_ring                    // A tube of rectangular cross section around `axis`
+    {
+        minalg::float3 axis;                // Unit axis
+        float radius;                       // Radius of the centerline
+        float half_width, half_thickness;   // Half the extent of the cross section, radially and along the axis
+    };
+    struct impostor_box { minalg::float3 center, half_extents; };
+    struct gizmo_impostor
+    {
+        minalg::float3 origin;              // World-space center of the gizmo
+        float scale;                        // Draw scale of the gizmo
+        minalg::float4 orientation;         // Orientation of the gizmo frame
+        impostor_shape shape;
+        impostor_shaft shaft;
+        impostor_ring ring;
+        impostor_box box;
+        minalg::float4 color;
+        interact component;
+    };
+
+    float gizmo_impostor_distance(const gizmo_impostor & impostor, const minalg::float3 & point); // Reference signed distance, in world units
+    void gizmo_impostor_bounds(const gizmo_impostor & impostor, minalg::float3 & center, float & radius); // World-space bounding sphere
+    bool intersect_gizmo_impostor(const gizmo_impostor & impostor, const minalg::float3 & ray_origin, const minalg::float3 & ray_direction, float * hit_t); // Reference fragment evaluation by sphere tracing
+
     struct gizmo_application_state
     {
         bool mouse_left{ false };
@@ -485,10 +721,46 @@ namespace tinygizmo
         float snap_translation{ 0.f };      // World-scale units used for snapping translation
         float snap_scale{ 0.f };            // World-scale units used for snapping scale
         float snap_rotation{ 0.f };         // Radians used for snapping rotation quaternions (i.e. PI/8 or PI/16)
+        bool trim_rotation_rings{ false };  // If true, only the camera-facing half of each rotation ring is drawn and picked
+        geometry_space output_space{ geometry_space::world }; // If not world, vertices are projected with `cam` and `viewport_size` so the renderer needs no view projection. Normals stay in world space. Ignored in stereo mode
         minalg::float2 viewport_size;       // 3d viewport used to render the view
-        minalg::float3 ray_origin;          // world-space ray origin (i.e. the camera position)
+        minalg::float3 ray_origin;          // world-space ray origin (i.e. the camera position, or the cursor on the near plane of an orthographic camera)
         minalg::float3 ray_direction;       // world-space ray direction
         camera_parameters cam;              // Used for constructing inverse view projection for raycasting onto gizmo geometry
+        bool stereo{ false };               // If true, `cam` is derived from the center of `eyes` and one world-space mesh is drawn for both eyes
+        camera_parameters eyes[2];          // Left and right eye cameras in stereo mode; `ray_origin` and `ray_direction` are still a single ray
+
+        // Matrices the app already computed for its own rendering. If `camera_matrices` is set, `cam`, `ray_origin` and
+        // `ray_direction` are not read: the camera is recovered from `view` and `inverse_view_projection` once per update, the ray
+        // is cast through `cursor`, and culling and projected output use `projection * view`. The view must be rigid. The projection
+        // may be perspective or orthographic, and must have the depth range of TINYGIZMO_CONVENTION. Ignored in stereo mode and for the viewports of a multi-view update.
+        bool camera_matrices{ false };
+        minalg::float4x4 view, projection, inverse_view_projection;
+        minalg::float2 cursor;              // Cursor position in pixels within `viewport_size`, y down
+    };
+
+    // One of several views served by a single context. The cursor ray must be supplied for every viewport, since a drag keeps
+    // following the ray of the viewport it started in even when the cursor moves over another one.
+    struct gizmo_viewport
+    {
+        camera_parameters cam;
+        minalg::float2 viewport_size;
+        float screenspace_scale{ 0.f };     // If > 0.f, the gizmos are drawn scale-invariant in this viewport
+        minalg::float3 ray_origin;          // world-space ray origin through the cursor, for this viewport's camera
+        minalg::float3 ray_direction;       // world-space ray direction
+        bool hovered{ false };              // True for the viewport under the cursor, which receives picking
+    };
+
+    enum class cpu_tier { scalar, sse2, avx };  // Instruction sets of the picking, vertex transform and merge kernels, in increasing order
+    cpu_tier detect_cpu_tier();                 // Best tier supported by the host, checked at runtime
+
+    struct gizmo_stats
+    {
+        uint32_t gizmos{ 0 };               // Gizmos processed by `transform_gizmo(...)`, once per viewport
+        uint32_t culled_behind{ 0 };        // Gizmos entirely behind the camera
+        uint32_t culled_outside{ 0 };       // Gizmos entirely outside the view frustum
+        uint32_t culled_subpixel{ 0 };      // Gizmos smaller than a pixel
+        uint32_t components_hidden{ 0 };    // Components of drawn gizmos hidden because they project to a point or a line
     };
 
     struct gizmo_context
@@ -496,17 +768,91 @@ namespace tinygizmo
         struct gizmo_context_impl;
         std::unique_ptr<gizmo_context_impl> impl;
 
-        gizmo_context();
+        gizmo_context() : gizmo_context(cpu_tier::avx, convention()) {}
+        explicit gizmo_context(cpu_tier max_tier) : gizmo_context(max_tier, convention()) {} // Run the kernels at the best tier the host supports, but no higher than `max_tier`, e.g. to test the scalar path
+        template<class Convention> gizmo_context(cpu_tier max_tier, Convention); // Defined by the library only for the convention it was built with
         ~gizmo_context();
 
         void update(const gizmo_application_state & state);         // Clear geometry buffer and update internal `gizmo_application_state` data
+        void update(const gizmo_application_state & state, const std::vector<gizmo_viewport> & viewports); // As above, for several viewports that override the camera, scale and ray of `state`
+        uint32_t get_active_viewport() const;                       // Viewport receiving picking and dragging: the hovered one, latched while the mouse button is held
         void draw();                                                // Trigger a render callback per call to `update(...)`
         transform_mode get_mode() const;                            // Return the active mode being used by `transform_gizmo(...)`
+        uint64_t get_generation() const;                            // Incremented by `draw()` when its geometry differs from the previous frame; if unchanged, the GPU upload can be skipped
+        const std::vector<geometry_range> & get_dirty_ranges() const; // Ranges of the `render` mesh rewritten by the last `draw()`; each gizmo keeps its range until gizmos appear or disappear
+        const gizmo_stats & get_stats() const;                      // Counters since the last call to `update(...)`
+        cpu_tier get_cpu_tier() const;                              // Tier the kernels were selected at when the context was created
         std::function<void(const geometry_mesh & r)> render;        // Callback to render the gizmo meshes
+        std::function<void(const geometry_streams & s)> render_streams; // Callback to render the gizmo meshes as separate position/normal/color/index streams
+        std::function<void(const geometry_chunk & c)> render_chunk; // Callback invoked with chunks of at most 65536 vertices (16-bit indices) as they fill, without building a merged mesh. Only two chunks are buffered, but the per-gizmo geometry they are copied from is retained as for every other output
+        std::function<void(const geometry_view & v)> render_component; // Callback invoked once per gizmo component with a view into its geometry, without building a merged mesh
+        std::function<void(const geometry_mesh & opaque, const geometry_mesh & transparent)> render_batches; // Callback to render opaque and translucent components as separate meshes, the latter sorted back to front
+        std::function<void(uint32_t viewport, const geometry_mesh & r)> render_viewport; // Callback invoked by `draw()` with the gizmo meshes of each viewport; the other callbacks only receive viewport 0
+        std::function<void(const geometry_lines & l)> render_lines; // Callback to render the gizmos as a line list instead of triangles. While set, picking tests screen-space distance to the lines. If no triangle callback is set, no triangle meshes are generated
+        std::function<void(const std::vector<gizmo_impostor> & i)> render_impostors; // Callback to render the gizmo components as analytic impostors instead of meshes
     };
 
     bool transform_gizmo(const std::string & name, gizmo_context & g, rigid_transform & t);
 
+    // Entry points with a fixed mode and space, and a subset of the handles. Unlike `transform_gizmo(...)`, they ignore the mode and
+    // local toggle hotkeys. The default set of handles of each runs a specialization where the tests on the space and handles fold
+    // away; any other combination of the seven flags for translation, and of `components::axes` otherwise, tests them at runtime.
+    enum class gizmo_space { global, local };
+    namespace components
+    {
+        enum : uint32_t
+        {
+            x = 1 << 0, y = 1 << 1, z = 1 << 2,                         // Axis arrows, rings or maces
+            yz_plane = 1 << 3, zx_plane = 1 << 4, xy_plane = 1 << 5,    // Translation planes
+            xyz = 1 << 6,                                               // Translation in the view plane
+            axes = x | y | z, planes = yz_plane | zx_plane | xy_plane, all = axes | planes | xyz
+        };
+    }
+    bool translate_gizmo(const std::string & name, gizmo_context & g, rigid_transform & t, gizmo_space space, uint32_t set = components::all);
+    bool rotate_gizmo(const std::string & name, gizmo_context & g, rigid_transform & t, gizmo_space space, uint32_t set = components::axes);
+    bool scale_gizmo(const std::string & name, gizmo_context & g, rigid_transform & t, uint32_t set = components::axes); // Always local
+
+    // The same with the space and handles as template arguments, e.g. `translate_gizmo<gizmo_space::local, components::axes>(...)`
+    template<gizmo_space Space, uint32_t Components = components::all> bool translate_gizmo(const std::string & name, gizmo_context & g, rigid_transform & t) { return translate_gizmo(name, g, t, Space, Components); }
+    template<gizmo_space Space, uint32_t Components = components::axes> bool rotate_gizmo(const std::string & name, gizmo_context & g, rigid_transform & t) { return rotate_gizmo(name, g, t, Space, Components); }
+    template<uint32_t Components = components::axes> bool scale_gizmo(const std::string & name, gizmo_context & g, rigid_transform & t) { return scale_gizmo(name, g, t, Components); }
+
+    ////////////////////////////
+    //   User Math Adapters   //
+    ////////////////////////////
+
+    // Specialize math_type to hand a user vector, quaternion, matrix, vertex or transform type to tinygizmo in place, e.g.
+    //     namespace tinygizmo { template<> struct math_type<Vec3> { typedef minalg::float3 type; }; }
+    // The user type must hold the same members in the same order: x, y, z, w for quaternions, columns for matrices and
+    // position, orientation, scale for transforms. math_cast checks the size, alignment and layout of both types at compile
+    // time and reinterprets the reference, so that nothing is converted or copied per call. Fields of gizmo_application_state
+    // are assigned from `as_gizmo(v)`, and the specialized entry points above take `as_gizmo(t)` for a user transform.
+    template<class T> struct math_type {};
+    template<class T, int M> struct math_type<minalg::vec<T, M>> { typedef minalg::vec<T, M> type; };
+    template<class T, int M, int N> struct math_type<minalg::mat<T, M, N>> { typedef minalg::mat<T, M, N> type; };
+    template<> struct math_type<rigid_transform> { typedef rigid_transform type; };
+    template<> struct math_type<camera_parameters> { typedef camera_parameters type; };
+    template<> struct math_type<geometry_vertex> { typedef geometry_vertex type; };
+
+    template<class To, class From> void check_math_layout()
+    {
+        static_assert(std::is_same<typename math_type<To>::type, typename math_type<From>::type>::value, "math_cast requires both types to adapt the same tinygizmo type");
+        static_assert(sizeof(To) == sizeof(From), "math_cast requires types of the same size");
+        static_assert(alignof(From) % alignof(To) == 0, "math_cast requires the source to be at least as aligned as the destination");
+        static_assert(std::is_standard_layout<To>::value && std::is_standard_layout<From>::value, "math_cast requires types with standard layout");
+    }
+    template<class To, class From> To & math_cast(From & f) { check_math_layout<To, From>(); return reinterpret_cast<To &>(f); }
+    template<class To, class From> const To & math_cast(const From & f) { check_math_layout<To, From>(); return reinterpret_cast<const To &>(f); }
+    template<class To, class From> To * math_cast(From * f) { check_math_layout<To, From>(); return reinterpret_cast<To *>(f); }
+    template<class To, class From> const To * math_cast(const From * f) { check_math_layout<To, From>(); return reinterpret_cast<const To *>(f); }
+    template<class T> typename math_type<T>::type & as_gizmo(T & t) { return math_cast<typename math_type<T>::type>(t); }
+    template<class T> const typename math_type<T>::type & as_gizmo(const T & t) { return math_cast<typename math_type<T>::type>(t); }
+
+    template<class T> typename std::enable_if<std::is_same<typename math_type<T>::type, rigid_transform>::value, bool>::type transform_gizmo(const std::string & name, gizmo_context & g, T & t)
+    {
+        return transform_gizmo(name, g, as_gizmo(t));
+    }
+
 } // end namespace tinygizmo;
 
 #endif // end tinygizmo_hpp
@@ -0,0 +1,80 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org>
+
+// Post-transform cache optimization of the component meshes: `optimize_geometry` must keep every triangle, and the benchmark
+// reports the simulated average cache miss ratio (vertices transformed per triangle) before and after it
+
+#include "test.hpp"
+#include "../src/tiny-gizmo.hpp"
+#include <algorithm>
+#include <array>
+
+using namespace tinygizmo;
+using namespace minalg;
+
+// Generators of the component meshes, defined in tiny-gizmo.cpp
+geometry_mesh make_box_geometry(const float3 & min_bounds, const float3 & max_bounds);
+geometry_mesh make_cylinder_geometry(const float3 & axis, const float3 & arm1, const float3 & arm2, uint32_t slices);
+geometry_mesh make_lathed_geometry(const float3 & axis, const float3 & arm1, const float3 & arm2, int slices, const std::vector<float2> & points, const float eps);
+
+struct named_mesh { const char * name; geometry_mesh mesh; };
+
+static std::vector<named_mesh> make_component_meshes()
+{
+    const std::vector<float2> arrow_points = { { 0.25f, 0 }, { 0.25f, 0.05f },{ 1, 0.05f },{ 1, 0.10f },{ 1.2f, 0 } };
+    const std::vector<float2> mace_points = { { 0.25f, 0 }, { 0.25f, 0.05f },{ 1, 0.05f },{ 1, 0.1f },{ 1.25f, 0.1f }, { 1.25f, 0 } };
+    const std::vector<float2> ring_points = { { +0.025f, 1 },{ -0.025f, 1 },{ -0.025f, 1 },{ -0.025f, 1.1f },{ -0.025f, 1.1f },{ +0.025f, 1.1f },{ +0.025f, 1.1f },{ +0.025f, 1 } };
+    return{
+        { "arrow", make_lathed_geometry({ 1,0,0 },{ 0,1,0 },{ 0,0,1 }, 16, arrow_points, 0.0f) },
+        { "mace", make_lathed_geometry({ 1,0,0 },{ 0,1,0 },{ 0,0,1 }, 16, mace_points, 0.0f) },
+        { "ring", make_lathed_geometry({ 0,0,1 },{ 1,0,0 },{ 0,1,0 }, 32, ring_points, 0.0f) },
+        { "cylinder", make_cylinder_geometry({ 0,0,1 },{ 1,0,0 },{ 0,1,0 }, 24) },
+        { "box", make_box_geometry({ 0.25f,0.25f,-0.01f },{ 0.75f,0.75f,0.01f }) },
+    };
+}
+
+// Corner positions of every triangle, rotated to start at its smallest corner so that the comparison ignores which corner an
+// index buffer starts a triangle at, then sorted
+static std::vector<std::array<float, 9>> triangle_positions(const geometry_mesh & mesh)
+{
+    std::vector<std::array<float, 9>> result;
+    for (auto & t : mesh.triangles)
+    {
+        std::array<std::array<float, 3>, 3> corners;
+        for (int i = 0; i < 3; ++i) corners[i] = { { mesh.vertices[t[i]].position.x, mesh.vertices[t[i]].position.y, mesh.vertices[t[i]].position.z } };
+        std::rotate(corners.begin(), std::min_element(corners.begin(), corners.end()), corners.end());
+        std::array<float, 9> flat;
+        for (int i = 0; i < 9; ++i) flat[i] = corners[i / 3][i % 3];
+        result.push_back(flat);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+TEST(optimize_geometry_keeps_triangles)
+{
+    for (auto & m : make_component_meshes())
+    {
+        geometry_mesh optimized = m.mesh;
+        optimize_geometry(optimized);
+        CHECK(optimized.triangles.size() == m.mesh.triangles.size());
+        CHECK(optimized.vertices.size() <= m.mesh.vertices.size());
+        CHECK(triangle_positions(optimized) == triangle_positions(m.mesh));
+        CHECK(compute_acmr(optimized) <= compute_acmr(m.mesh));
+    }
+}
+
+BENCH(acmr_before_and_after_optimize_geometry)
+{
+    std::printf("    %-10s %10s %8s %8s %8s %12s\n", "mesh", "triangles", "cache", "before", "after", "optimize us");
+    for (auto & m : make_component_meshes())
+    {
+        for (uint32_t cache_size : { 8u, 16u, 32u })
+        {
+            geometry_mesh optimized = m.mesh;
+            optimize_geometry(optimized, cache_size);
+            const double seconds = seconds_per_call([&]() { geometry_mesh copy = m.mesh; optimize_geometry(copy, cache_size); return float(copy.triangles.size()); });
+            std::printf("    %-10s %10d %8u %8.3f %8.3f %12.2f\n", m.name, int(m.mesh.triangles.size()), cache_size, compute_acmr(m.mesh, cache_size), compute_acmr(optimized, cache_size), seconds * 1e6);
+        }
+    }
+}
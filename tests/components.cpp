@@ -0,0 +1,69 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org>
+
+// The fixed-mode entry points draw and pick exactly the handles they are given, whether the set is one of the specialized
+// defaults or goes through the runtime path
+
+#include "test.hpp"
+#include "scene.hpp"
+#include <algorithm>
+
+using namespace tinygizmo;
+using namespace minalg;
+
+// Components drawn for one frame of `gizmo`, sorted
+template<class F> std::vector<interact> drawn_components(F gizmo)
+{
+    gizmo_context ctx;
+    std::vector<interact> drawn;
+    ctx.render_component = [&](const geometry_view & v) { drawn.push_back(v.component); };
+    test_scene scene;
+    ctx.update(scene.state);
+    rigid_transform t;
+    gizmo(ctx, t);
+    ctx.draw();
+    std::sort(drawn.begin(), drawn.end());
+    return drawn;
+}
+
+TEST(gizmo_components_select_handles)
+{
+    typedef std::vector<interact> list;
+    const list translation = { interact::translate_x, interact::translate_y, interact::translate_z, interact::translate_yz, interact::translate_zx, interact::translate_xy, interact::translate_xyz };
+
+    // Specialized defaults, through the template and the runtime overload
+    CHECK(drawn_components([](gizmo_context & g, rigid_transform & t) { translate_gizmo<gizmo_space::global>("a", g, t); }) == translation);
+    CHECK(drawn_components([](gizmo_context & g, rigid_transform & t) { translate_gizmo("a", g, t, gizmo_space::local); }) == translation);
+    CHECK(drawn_components([](gizmo_context & g, rigid_transform & t) { rotate_gizmo<gizmo_space::local>("a", g, t); }) == list({ interact::rotate_x, interact::rotate_y, interact::rotate_z }));
+    CHECK(drawn_components([](gizmo_context & g, rigid_transform & t) { scale_gizmo<>("a", g, t); }) == list({ interact::scale_x, interact::scale_y, interact::scale_z }));
+
+    // Other sets take the runtime path
+    CHECK(drawn_components([](gizmo_context & g, rigid_transform & t) { translate_gizmo<gizmo_space::local, components::axes>("a", g, t); }) == list({ interact::translate_x, interact::translate_y, interact::translate_z }));
+    CHECK(drawn_components([](gizmo_context & g, rigid_transform & t) { translate_gizmo("a", g, t, gizmo_space::global, components::xy_plane | components::xyz); }) == list({ interact::translate_xy, interact::translate_xyz }));
+    CHECK(drawn_components([](gizmo_context & g, rigid_transform & t) { rotate_gizmo<gizmo_space::global, components::z>("a", g, t); }) == list({ interact::rotate_z }));
+    CHECK(drawn_components([](gizmo_context & g, rigid_transform & t) { scale_gizmo("a", g, t, components::x | components::y); }) == list({ interact::scale_x, interact::scale_y }));
+    CHECK(drawn_components([](gizmo_context & g, rigid_transform & t) { scale_gizmo<0>("a", g, t); }).empty());
+}
+
+TEST(gizmo_components_pick_only_selected_handles)
+{
+    // Press on the x arrow and drag along x, which only moves the gizmo when that handle is selected
+    for (const uint32_t set : { uint32_t(components::all), uint32_t(components::x), uint32_t(components::y | components::z) })
+    {
+        gizmo_context ctx;
+        ctx.render = [](const geometry_mesh &) {};
+        test_scene scene;
+        rigid_transform t;
+        for (int frame = 0; frame < 8; ++frame)
+        {
+            const float3 target = float3(0.6f, 0, 0) + float3(0.05f, 0, 0) * float(frame);
+            scene.state.mouse_left = frame >= 2;
+            scene.state.ray_origin = scene.state.cam.position;
+            scene.state.ray_direction = normalize(target - scene.state.cam.position);
+            ctx.update(scene.state);
+            translate_gizmo("a", ctx, t, gizmo_space::global, set);
+            ctx.draw();
+        }
+        CHECK((t.position.x > 0.1f) == ((set & components::x) != 0));
+    }
+}
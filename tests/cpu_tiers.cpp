@@ -0,0 +1,66 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org>
+
+// The SSE2 and AVX kernels evaluate the same expressions in the same order as the scalar ones, so every tier the host supports
+// must give bit-identical geometry and interaction to a context limited to `cpu_tier::scalar`
+
+#include "test.hpp"
+#include "scene.hpp"
+#include <cstring>
+
+using namespace tinygizmo;
+using namespace minalg;
+
+// Everything the scene produces over its frames with one context: the transforms after each frame, and the triangle or line
+// geometry of each frame concatenated
+struct tier_trace
+{
+    std::vector<rigid_transform> transforms;
+    std::vector<geometry_vertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+template<class T> bool same_bits(const std::vector<T> & a, const std::vector<T> & b)
+{
+    return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+// With `lines` set only `render_lines` is used, which switches picking to the screen-space distance to the lines
+static tier_trace run_scene(cpu_tier tier, bool lines)
+{
+    gizmo_context ctx(tier);
+    CHECK(ctx.get_cpu_tier() == tier);
+
+    tier_trace trace;
+    auto append = [&](const std::vector<geometry_vertex> & vertices, const uint32_t * indices, size_t count)
+    {
+        trace.vertices.insert(trace.vertices.end(), vertices.begin(), vertices.end());
+        trace.indices.insert(trace.indices.end(), indices, indices + count);
+    };
+    if (lines) ctx.render_lines = [&](const geometry_lines & l) { append(l.vertices, &l.lines.data()->x, l.lines.size() * 2); };
+    else ctx.render = [&](const geometry_mesh & m) { append(m.vertices, &m.triangles.data()->x, m.triangles.size() * 3); };
+
+    test_scene scene;
+    for (int frame = 0; frame < 6 * test_scene::frames_per_mode; ++frame)
+    {
+        scene.run_frame(ctx, frame);
+        trace.transforms.insert(trace.transforms.end(), scene.transforms, scene.transforms + 3);
+    }
+    return trace;
+}
+
+TEST(cpu_tiers_match_scalar)
+{
+    for (const bool lines : { false, true })
+    {
+        const tier_trace scalar = run_scene(cpu_tier::scalar, lines);
+        CHECK(!scalar.indices.empty());
+        for (int tier = int(cpu_tier::scalar) + 1; tier <= int(detect_cpu_tier()); ++tier)
+        {
+            const tier_trace t = run_scene(cpu_tier(tier), lines);
+            CHECK(same_bits(t.transforms, scalar.transforms));
+            CHECK(same_bits(t.vertices, scalar.vertices));
+            CHECK(same_bits(t.indices, scalar.indices));
+        }
+    }
+}
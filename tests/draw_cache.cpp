@@ -0,0 +1,65 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org>
+
+// A frame in which no gizmo changed reuses the retained geometry: it must neither allocate nor advance the generation, and
+// report no dirty ranges. Allocations are counted by replacing the global operator new for the test binary.
+
+#include "test.hpp"
+#include "scene.hpp"
+#include <cstdlib>
+#include <new>
+
+using namespace tinygizmo;
+using namespace minalg;
+
+static bool counting_allocations = false;
+static int allocations = 0;
+
+void * operator new(size_t size)
+{
+    if (counting_allocations) ++allocations;
+    if (void * p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void * p) noexcept { std::free(p); }
+
+TEST(draw_cache_hit_does_not_allocate)
+{
+    const std::string names[3] = { "a", "b", "c" };
+    for (int mode = 0; mode < 3; ++mode) for (const bool trim : { false, true }) for (const bool lines : { false, true })
+    {
+        gizmo_context ctx;
+        if (lines) ctx.render_lines = [](const geometry_lines &) {};
+        else ctx.render = [](const geometry_mesh &) {};
+
+        // A static camera and cursor that hovers none of the gizmos
+        test_scene scene;
+        scene.state.trim_rotation_rings = trim;
+        scene.state.ray_origin = scene.state.cam.position;
+        scene.state.ray_direction = qrot(scene.state.cam.orientation, float3(0, 0.9f, -1));
+
+        uint64_t generation = 0;
+        for (int frame = 0; frame < 8; ++frame)
+        {
+            counting_allocations = frame >= 4;
+            ctx.update(scene.state);
+            for (int i = 0; i < 3; ++i)
+            {
+                if (mode == 0) translate_gizmo(names[i], ctx, scene.transforms[i], gizmo_space::global);
+                if (mode == 1) rotate_gizmo(names[i], ctx, scene.transforms[i], gizmo_space::local);
+                if (mode == 2) scale_gizmo(names[i], ctx, scene.transforms[i]);
+            }
+            ctx.draw();
+            counting_allocations = false;
+
+            if (frame >= 4)
+            {
+                CHECK(ctx.get_generation() == generation);
+                CHECK(ctx.get_dirty_ranges().empty());
+            }
+            generation = ctx.get_generation();
+        }
+        CHECK(allocations == 0);
+        allocations = 0;
+    }
+}
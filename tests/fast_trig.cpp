@@ -0,0 +1,94 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org>
+
+// The polynomial approximations behind TINYGIZMO_FAST_TRIG must stay within their documented error bounds, and snapping must
+// give the same results with and without them. build.bat runs these tests in both builds.
+
+#include "test.hpp"
+#include "scene.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace tinygizmo;
+using namespace minalg;
+
+// Defined in tiny-gizmo.cpp, and built regardless of TINYGIZMO_FAST_TRIG
+float fast_sin(float x);
+float fast_cos(float x);
+float fast_tan(float x);
+float fast_acos(float x);
+void fast_sincos(const float * angles, float * sines, float * cosines, size_t count);
+
+// Largest error of `f` against the double precision `reference` over `count` evenly spaced samples of [lo, hi]
+template<class F, class R> double max_error(F f, R reference, float lo, float hi, int count, bool relative)
+{
+    double worst = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        const float x = lo + (hi - lo) * float(i) / float(count - 1);
+        const double r = reference(double(x));
+        const double e = std::abs(double(f(x)) - r);
+        worst = std::max(worst, relative ? e / std::abs(r) : e);
+    }
+    return worst;
+}
+
+TEST(fast_trig_error_bounds)
+{
+    // Dense near zero, where most gizmo angles are, and coarser up to the documented range of the argument reduction
+    for (const float range : { 4.0f, 64.0f, 8191.0f })
+    {
+        CHECK(max_error(fast_sin, [](double x) { return std::sin(x); }, -range, range, 1 << 20, false) <= 2.1e-7);
+        CHECK(max_error(fast_cos, [](double x) { return std::cos(x); }, -range, range, 1 << 20, false) <= 2.1e-7);
+    }
+    CHECK(max_error(fast_acos, [](double x) { return std::acos(x); }, -1.0f, 1.0f, 1 << 20, false) <= 4.4e-7);
+    CHECK(max_error(fast_tan, [](double x) { return std::tan(x); }, -1.5f, 1.5f, 1 << 20, true) <= 1.6e-6);
+
+    // The batch variant used for geometry generation gives the same results as the scalar functions
+    std::vector<float> angles, sines(4096), cosines(4096);
+    for (int i = 0; i < 4096; ++i) angles.push_back(float(i - 2048) * 0.01f);
+    fast_sincos(angles.data(), sines.data(), cosines.data(), angles.size());
+    for (size_t i = 0; i < angles.size(); ++i) CHECK(sines[i] == fast_sin(angles[i]) && cosines[i] == fast_cos(angles[i]));
+}
+
+TEST(fast_trig_keeps_snapping)
+{
+    const float snap_rotation = 6.28318530718f / 16;
+    gizmo_context ctx;
+    ctx.render = [](const geometry_mesh &) {};
+    test_scene scene;
+    scene.state.snap_translation = 0.25f;
+    scene.state.snap_rotation = snap_rotation;
+    scene.state.snap_scale = 0.25f;
+
+    // Number of snap increments of the rotation at the end of each rotation drag
+    std::vector<int> rotation_snaps;
+    float4 drag_start;
+    for (int frame = 0; frame < 6 * test_scene::frames_per_mode; ++frame)
+    {
+        scene.run_frame(ctx, frame);
+        const rigid_transform & t = scene.transforms[0];
+        const int mode = (frame / test_scene::frames_per_mode) % 3, step = frame % test_scene::frames_per_mode;
+        if (mode == 1 && step == 14) drag_start = t.orientation;
+        if (mode == 1 && step == 29)
+        {
+            // The rotation applied by the drag must be a whole number of increments
+            const float4 delta = qmul(t.orientation, qconj(drag_start));
+            const float angle = 2 * std::acos(std::min(std::abs(delta.w), 1.0f));
+            const int snaps = int(std::floor(angle / snap_rotation + 0.5f));
+            CHECK(std::abs(angle - float(snaps) * snap_rotation) < 1e-3f);
+            rotation_snaps.push_back(snaps);
+        }
+    }
+
+    // Both rotation drags turn the first gizmo about x, so its orientation is the snapped total. Translation and scale do not depend on
+    // trigonometry in this scene; their values were recorded without TINYGIZMO_FAST_TRIG and are compared with a tolerance, since the
+    // approximations and a different compiler or instruction set may move the last bits.
+    const rigid_transform & t = scene.transforms[0];
+    CHECK(rotation_snaps == std::vector<int>({ 3, 3 }));
+    const float4 expected = rotation_quat(float3(1, 0, 0), float(std::accumulate(rotation_snaps.begin(), rotation_snaps.end(), 0)) * snap_rotation);
+    CHECK(std::min(length(t.orientation - expected), length(t.orientation + expected)) < 1e-5f);
+    CHECK(length(t.position - float3(0.655829668f, 0, 0)) < 1e-5f);
+    CHECK(length(t.scale - float3(1.5f, 1, 1)) < 1e-5f);
+}
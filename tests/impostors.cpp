@@ -0,0 +1,128 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org>
+
+// The analytic impostors must describe the same shapes as the component meshes: the signed distance vanishes on every mesh
+// vertex, and rays hit the same component with either representation, up to the tessellation
+
+#include "test.hpp"
+#include "scene.hpp"
+#include <cmath>
+#include <map>
+
+using namespace tinygizmo;
+using namespace minalg;
+
+struct component_geometry { std::vector<float3> positions; std::vector<uint3> triangles; gizmo_impostor impostor; };
+
+// World-space meshes and impostors of one gizmo, drawn with the given entry point from the scene camera
+template<class F> std::map<interact, component_geometry> capture(F gizmo, const rigid_transform & t)
+{
+    gizmo_context ctx;
+    std::map<interact, component_geometry> components;
+    ctx.render_component = [&](const geometry_view & v)
+    {
+        component_geometry & c = components[v.component];
+        for (uint32_t i = 0; i < v.vertex_count; ++i) c.positions.push_back(v.vertices[i].position);
+        c.triangles.assign(v.triangles, v.triangles + v.triangle_count);
+    };
+    ctx.render_impostors = [&](const std::vector<gizmo_impostor> & impostors) { for (auto & i : impostors) components[i.component].impostor = i; };
+    test_scene scene;
+    ctx.update(scene.state);
+    rigid_transform copy = t;
+    gizmo(ctx, copy);
+    ctx.draw();
+    return components;
+}
+
+// Möller-Trumbore, for the nearest hit of a ray with a triangle mesh
+static bool intersect_mesh(const component_geometry & c, const float3 & origin, const float3 & direction, float & hit_t)
+{
+    bool hit = false;
+    for (auto & tri : c.triangles)
+    {
+        const float3 v0 = c.positions[tri.x], e1 = c.positions[tri.y] - v0, e2 = c.positions[tri.z] - v0;
+        const float3 p = cross(direction, e2);
+        const float det = dot(e1, p);
+        if (std::abs(det) < 1e-12f) continue;
+        const float3 s = origin - v0;
+        const float u = dot(s, p) / det;
+        if (u < 0 || u > 1) continue;
+        const float3 q = cross(s, e1);
+        const float v = dot(direction, q) / det;
+        if (v < 0 || u + v > 1) continue;
+        const float t = dot(e2, q) / det;
+        if (t > 0 && (!hit || t < hit_t)) { hit_t = t; hit = true; }
+    }
+    return hit;
+}
+
+typedef void (*gizmo_function)(gizmo_context &, rigid_transform &);
+static const gizmo_function gizmos[] =
+{
+    [](gizmo_context & g, rigid_transform & t) { translate_gizmo("a", g, t, gizmo_space::local); },
+    [](gizmo_context & g, rigid_transform & t) { rotate_gizmo("a", g, t, gizmo_space::local); },
+    [](gizmo_context & g, rigid_transform & t) { scale_gizmo("a", g, t); },
+};
+
+static rigid_transform posed_transform()
+{
+    rigid_transform t;
+    t.position = { 0.2f, -0.1f, 0.3f };
+    t.orientation = rotation_quat(normalize(float3(1, 2, 3)), 0.7f);
+    return t;
+}
+
+TEST(impostors_vanish_on_mesh_vertices)
+{
+    for (auto gizmo : gizmos)
+    {
+        const auto components = capture(gizmo, posed_transform());
+        CHECK(!components.empty());
+        for (auto & c : components)
+        {
+            CHECK(!c.second.positions.empty());
+            float worst = 0;
+            for (auto & p : c.second.positions) worst = std::max(worst, std::abs(gizmo_impostor_distance(c.second.impostor, p)));
+            CHECK(worst < 6e-3f); // The mesh of the x and y rings is offset by 0.003 on each axis to avoid z-fighting
+        }
+    }
+}
+
+TEST(impostors_agree_with_mesh_picking)
+{
+    // Rays through a grid covering the gizmo, from the scene camera
+    const test_scene scene;
+    const float3 eye = scene.state.cam.position;
+    const rigid_transform t = posed_transform();
+    for (auto gizmo : gizmos)
+    {
+        const auto components = capture(gizmo, t);
+        int rays = 0, hits = 0, disagreements = 0;
+        float worst = 0;
+        for (int y = 0; y < 64; ++y) for (int x = 0; x < 64; ++x)
+        {
+            const float3 target = t.position + qrot(scene.state.cam.orientation, float3(float(x) - 31.5f, float(y) - 31.5f, 0) * (2.8f / 64));
+            const float3 direction = normalize(target - eye);
+            interact mesh_component = interact::none, impostor_component = interact::none;
+            float mesh_t = 0, impostor_t = 0;
+            for (auto & c : components)
+            {
+                float h = 0;
+                if (intersect_mesh(c.second, eye, direction, h) && (mesh_component == interact::none || h < mesh_t)) { mesh_component = c.first; mesh_t = h; }
+                if (intersect_gizmo_impostor(c.second.impostor, eye, direction, &h) && (impostor_component == interact::none || h < impostor_t)) { impostor_component = c.first; impostor_t = h; }
+            }
+            ++rays;
+            if (mesh_component == interact::none) { disagreements += impostor_component != interact::none; continue; }
+            ++hits;
+            disagreements += impostor_component != mesh_component;
+
+            // Mesh hits lie on the analytic surface up to the tessellation and the offset of the rings
+            worst = std::max(worst, std::abs(gizmo_impostor_distance(components.at(mesh_component).impostor, eye + direction * mesh_t)));
+        }
+
+        // Rays grazing a silhouette, most often of the thin rings, may hit only one of the tessellated mesh and the exact shape
+        CHECK(hits > rays / 50);
+        CHECK(disagreements <= hits / 10);
+        CHECK(worst < 0.01f);
+    }
+}
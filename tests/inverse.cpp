@@ -0,0 +1,83 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org>
+
+// The rigid inverses used for picking and for recovering the camera from the app's matrices must agree with the general
+// `inverse(...)`, and a camera given by its matrices must drag a gizmo exactly as the same camera given by its parameters
+
+#include "test.hpp"
+#include "scene.hpp"
+#include <cmath>
+
+using namespace tinygizmo;
+using namespace minalg;
+
+static float max_difference(const float4x4 & a, const float4x4 & b)
+{
+    float d = 0;
+    for (int j = 0; j < 4; ++j) for (int i = 0; i < 4; ++i) d = std::max(d, std::abs(a[j][i] - b[j][i]));
+    return d;
+}
+
+TEST(inverse_rigid_matches_inverse)
+{
+    for (const float angle : { 0.0f, 0.7f, 2.5f, -3.0f })
+    {
+        const float4x4 pose = mul(translation_matrix(float3(1, -2, 3.5f)), rotation_matrix(rotation_quat(normalize(float3(1, 2, 3)), angle)));
+        CHECK(max_difference(inverse_rigid(pose), inverse(pose)) < 1e-5f);
+        CHECK(max_difference(mul(inverse_rigid(pose), pose), translation_matrix(float3(0, 0, 0))) < 1e-5f);
+    }
+}
+
+TEST(rigid_transform_inverse_matches_inverse)
+{
+    const float3 points[] = { { 0, 0, 0 }, { 1, 2, 3 }, { -0.5f, 4, -2 } };
+    for (const float3 scale : { float3(1, 1, 1), float3(2, 0.5f, 3), float3(-1, 1, 0.25f) })
+    {
+        const rigid_transform t(rotation_quat(normalize(float3(-1, 2, 0.5f)), 1.3f), { 0.2f, -1, 4 }, scale);
+        const rigid_transform_inverse i(t);
+        CHECK(max_difference(i.matrix(), inverse(t.matrix())) < 1e-5f);
+        for (auto & p : points)
+        {
+            CHECK(length(i.detransform_point(t.transform_point(p)) - p) < 1e-5f);
+            CHECK(length(i.detransform_vector(t.transform_vector(p)) - p) < 1e-5f);
+            CHECK(length(i.detransform_point(p) - t.detransform_point(p)) < 1e-5f);
+        }
+    }
+}
+
+// Presses on the x arrow of a gizmo at the origin from the scene camera and drags along x, either with the camera parameters and
+// a ray through the target, or with `camera_matrices` and the cursor at the target's pixel
+static float3 drag_x(bool matrices)
+{
+    gizmo_context ctx;
+    ctx.render = [](const geometry_mesh &) {};
+    test_scene scene;
+    gizmo_application_state & state = scene.state;
+    state.camera_matrices = matrices;
+    state.view = inverse_rigid(mul(translation_matrix(state.cam.position), rotation_matrix(state.cam.orientation)));
+    state.projection = perspective_matrix(state.cam.yfov, state.viewport_size.x / state.viewport_size.y, state.cam.near_clip, state.cam.far_clip, neg_z, convention::depth);
+    const float4x4 view_projection = mul(state.projection, state.view);
+    state.inverse_view_projection = inverse(view_projection);
+
+    rigid_transform t;
+    for (int frame = 0; frame < 8; ++frame)
+    {
+        const float3 target = float3(0.6f, 0, 0) + float3(0.05f, 0, 0) * float(std::max(frame - 2, 0));
+        const float4 clip = mul(view_projection, float4(target, 1));
+        state.cursor = { (clip.x / clip.w + 1) * state.viewport_size.x / 2, (1 - clip.y / clip.w) * state.viewport_size.y / 2 };
+        state.ray_origin = state.cam.position;
+        state.ray_direction = normalize(target - state.cam.position);
+        state.mouse_left = frame >= 2;
+        ctx.update(state);
+        translate_gizmo("a", ctx, t, gizmo_space::global);
+        ctx.draw();
+    }
+    return t.position;
+}
+
+TEST(camera_matrices_match_camera_parameters)
+{
+    const float3 given = drag_x(false), recovered = drag_x(true);
+    CHECK(std::abs(given.x - 0.25f) < 0.01f); // The press lands on the surface of the arrow rather than on its axis
+    CHECK(length(recovered - given) < 1e-4f);
+}
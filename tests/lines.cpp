@@ -0,0 +1,78 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org>
+
+// Line output is picked with the same lines that are drawn: trimmed rotation rings only pick their camera-facing half, as the
+// meshes do, and at each level of detail the rings have one segment per slice of their mesh
+
+#include "test.hpp"
+#include "scene.hpp"
+
+using namespace tinygizmo;
+using namespace minalg;
+
+// Whether pressing the mouse over `point` starts dragging a rotation gizmo at the origin
+static bool picks(bool lines, bool trim, const float3 & point)
+{
+    gizmo_context ctx;
+    if (lines) ctx.render_lines = [](const geometry_lines &) {};
+    else ctx.render = [](const geometry_mesh &) {};
+    test_scene scene;
+    scene.state.trim_rotation_rings = trim;
+    scene.state.ray_origin = scene.state.cam.position;
+    scene.state.ray_direction = normalize(point - scene.state.cam.position);
+
+    rigid_transform t;
+    bool active = false;
+    for (int frame = 0; frame < 2; ++frame)
+    {
+        scene.state.mouse_left = frame == 1;
+        ctx.update(scene.state);
+        active = rotate_gizmo("a", ctx, t, gizmo_space::local);
+        ctx.draw();
+    }
+    return active;
+}
+
+TEST(lines_pick_trimmed_rings)
+{
+    // Points on the centerline of the y ring, a quarter turn either side of the camera, away from the other rings
+    const float3 eye = test_scene().state.cam.position;
+    const float3 toward = normalize(float3(eye.x, 0, eye.z));
+    const float3 front = qrot(rotation_quat(float3(0, 1, 0), 0.8f), toward) * 1.05f, back = -front;
+
+    for (const bool lines : { false, true })
+    {
+        CHECK(picks(lines, false, front));
+        CHECK(picks(lines, false, back));
+        CHECK(picks(lines, true, front));
+        CHECK(!picks(lines, true, back));
+    }
+}
+
+TEST(lines_follow_ring_lod)
+{
+    // With only the camera-facing half of the y ring drawn, its polyline has one vertex per slice boundary of the mesh drawn at the
+    // same level of detail. The mesh has 8 profile points per boundary, and repeats one boundary where the kept slices wrap around.
+    std::vector<size_t> counts;
+    for (const float distance : { 4.0f, 16.0f, 40.0f })
+    {
+        gizmo_context ctx;
+        size_t line_vertices = 0, mesh_vertices = 0;
+        ctx.render_lines = [&](const geometry_lines & l) { line_vertices = l.vertices.size(); };
+        ctx.render_component = [&](const geometry_view & v) { mesh_vertices = v.vertex_count; };
+        test_scene scene;
+        scene.state.trim_rotation_rings = true;
+        scene.state.cam.far_clip = 1000.0f;
+        scene.state.cam.position = normalize(scene.state.cam.position) * distance;
+        scene.state.ray_origin = scene.state.cam.position;
+        scene.state.ray_direction = qrot(scene.state.cam.orientation, float3(0, 1, 0)); // Away from the gizmo
+
+        rigid_transform t;
+        ctx.update(scene.state);
+        rotate_gizmo<gizmo_space::local, components::y>("a", ctx, t);
+        ctx.draw();
+        CHECK(mesh_vertices / 8 == line_vertices || mesh_vertices / 8 == line_vertices + 1);
+        counts.push_back(line_vertices);
+    }
+    CHECK(counts == std::vector<size_t>({ 32 / 2 + 2, 16 / 2 + 2, 8 / 2 + 2 }));
+}
@@ -0,0 +1,19 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org>
+
+#include "test.hpp"
+#include <cstring>
+
+// Runs the tests, or with --bench the benchmarks. Returns non-zero if any CHECK failed.
+int main(int argc, char * argv[])
+{
+    const bool bench = argc > 1 && std::strcmp(argv[1], "--bench") == 0;
+    for (auto & c : test_cases())
+    {
+        if (c.bench != bench) continue;
+        std::printf("%s\n", c.name);
+        c.run();
+    }
+    std::printf(test_failures() ? "%d checks failed\n" : "all checks passed\n", test_failures());
+    return test_failures() ? 1 : 0;
+}
@@ -0,0 +1,137 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org>
+
+// An orthographic viewport draws scale-invariant gizmos at the same size at every depth, culls against its box-shaped view
+// volume, and picks with rays parallel to the view direction, whether its camera is given or recovered from the app's matrices
+
+#include "test.hpp"
+#include "scene.hpp"
+#include <cmath>
+
+using namespace tinygizmo;
+using namespace minalg;
+
+static camera_parameters orthographic_camera()
+{
+    camera_parameters cam = test_scene().state.cam;
+    cam.orthographic = true;
+    cam.ortho_height = 4.0f;
+    return cam;
+}
+
+static float3 forward_of(const camera_parameters & cam) { return qrot(cam.orientation, float3(0, 0, -1)); }
+
+// Largest distance from `position` of the vertices drawn in each of a perspective and an orthographic viewport
+static float2 drawn_extents(const float3 & position, float screenspace_scale)
+{
+    gizmo_context ctx;
+    float2 extents;
+    ctx.render_viewport = [&](uint32_t viewport, const geometry_mesh & m) { for (auto & v : m.vertices) extents[viewport] = std::max(extents[viewport], length(v.position - position)); };
+
+    test_scene scene;
+    std::vector<gizmo_viewport> views(2);
+    views[0].cam = scene.state.cam;
+    views[1].cam = orthographic_camera();
+    for (auto & v : views)
+    {
+        v.viewport_size = scene.state.viewport_size;
+        v.screenspace_scale = screenspace_scale;
+        v.ray_origin = v.cam.position;
+        v.ray_direction = -forward_of(v.cam); // Away from the gizmo
+    }
+    views[0].hovered = true;
+
+    rigid_transform t;
+    t.position = position;
+    ctx.update(scene.state, views);
+    translate_gizmo("a", ctx, t, gizmo_space::global);
+    ctx.draw();
+    return extents;
+}
+
+TEST(orthographic_viewport_keeps_screenspace_scale)
+{
+    const camera_parameters cam = orthographic_camera();
+    const float2 near = drawn_extents(cam.position + forward_of(cam) * 3.0f, 80.0f);
+    const float2 far = drawn_extents(cam.position + forward_of(cam) * 24.0f, 80.0f);
+    CHECK(near.x > 0 && near.y > 0);
+    CHECK(far.x > near.x * 4);
+    CHECK(std::abs(far.y - near.y) < near.y * 1e-4f);
+
+    // The arrows of a gizmo scaled to 80 pixels span the same fraction of the view volume's height
+    const float gizmo_units = near.y / (cam.ortho_height * 80.0f / 720.0f);
+    CHECK(std::abs(far.x / (std::tan(cam.yfov) * 24.0f * 80.0f / 720.0f) - gizmo_units) < gizmo_units * 0.05f);
+}
+
+TEST(orthographic_viewport_culls_its_view_volume)
+{
+    // Lateral offsets of 2 units are inside the perspective frustum at a depth of 20, but outside the 4 unit high box
+    const camera_parameters cam = orthographic_camera();
+    const float3 up = qrot(cam.orientation, float3(0, 1, 0));
+    for (const bool orthographic : { false, true })
+    {
+        gizmo_context ctx;
+        ctx.render = [](const geometry_mesh &) {};
+        test_scene scene;
+        std::vector<gizmo_viewport> views(1);
+        views[0].cam = orthographic ? cam : scene.state.cam;
+        views[0].viewport_size = scene.state.viewport_size;
+        views[0].ray_origin = cam.position;
+        views[0].ray_direction = -forward_of(cam);
+
+        ctx.update(scene.state, views);
+        rigid_transform t[3];
+        t[0].position = cam.position + forward_of(cam) * 20.0f;
+        t[1].position = t[0].position + up * 4.0f;
+        t[2].position = t[0].position - up * 4.0f;
+        for (int i = 0; i < 3; ++i) translate_gizmo(std::string(1, char('a' + i)), ctx, t[i], gizmo_space::global);
+        CHECK(ctx.get_stats().gizmos == 3);
+        CHECK(ctx.get_stats().culled_outside == (orthographic ? 2u : 0u));
+        CHECK(ctx.get_stats().culled_subpixel == 0);
+        ctx.draw();
+    }
+}
+
+// Presses on the x arrow of a gizmo at the origin through an orthographic camera, then drags the cursor along x. With
+// `matrices`, the camera and ray are recovered from the view and projection; otherwise the ray is parallel to the view direction.
+static float drag_x(bool lines, bool matrices)
+{
+    const camera_parameters cam = orthographic_camera();
+    const float2 size = { 1280, 720 };
+    const float half_height = cam.ortho_height / 2, half_width = half_height * size.x / size.y;
+
+    gizmo_context ctx;
+    if (lines) ctx.render_lines = [](const geometry_lines &) {};
+    else ctx.render = [](const geometry_mesh &) {};
+    gizmo_application_state state;
+    state.viewport_size = size;
+    state.cam = cam;
+    state.camera_matrices = matrices;
+    state.view = inverse(mul(translation_matrix(cam.position), rotation_matrix(cam.orientation)));
+    state.projection = orthographic_matrix(-half_width, half_width, -half_height, half_height, cam.near_clip, cam.far_clip, neg_z, convention::depth);
+    const float4x4 view_projection = mul(state.projection, state.view);
+    state.inverse_view_projection = inverse(view_projection);
+
+    rigid_transform t;
+    for (int frame = 0; frame < 8; ++frame)
+    {
+        const float3 target = float3(0.6f, 0, 0) + float3(0.05f, 0, 0) * float(std::max(frame - 2, 0));
+        const float4 clip = mul(view_projection, float4(target, 1));
+        state.cursor = { (clip.x / clip.w + 1) * size.x / 2, (1 - clip.y / clip.w) * size.y / 2 };
+        state.ray_origin = target - forward_of(cam) * 10.0f;
+        state.ray_direction = forward_of(cam);
+        state.mouse_left = frame >= 2;
+        ctx.update(state);
+        translate_gizmo("a", ctx, t, gizmo_space::global);
+        ctx.draw();
+    }
+    return t.position.x;
+}
+
+TEST(orthographic_viewport_picks_with_parallel_rays)
+{
+    for (const bool lines : { false, true }) for (const bool matrices : { false, true })
+    {
+        CHECK(std::abs(drag_x(lines, matrices) - 0.25f) < 1e-3f);
+    }
+}
@@ -0,0 +1,64 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org>
+
+// Deterministic input shared by the tests that drive a gizmo_context. Three gizmos are drawn from a fixed camera while the
+// script cycles through translation, rotation and scale: each mode sweeps the cursor across the gizmo at the origin, then
+// drags one of its handles, and every other cycle uses the local toggle.
+
+#pragma once
+
+#ifndef tinygizmo_scene_hpp
+#define tinygizmo_scene_hpp
+
+#include "../src/tiny-gizmo.hpp"
+
+struct test_scene
+{
+    static const int frames_per_mode = 40;
+
+    tinygizmo::gizmo_application_state state;
+    tinygizmo::rigid_transform transforms[3];
+    minalg::float3 anchor;              // Position of the first gizmo at the start of the current mode, which the cursor moves relative to
+
+    test_scene()
+    {
+        state.viewport_size = { 1280, 720 };
+        state.cam.yfov = 1.0f;
+        state.cam.near_clip = 0.01f;
+        state.cam.far_clip = 32.0f;
+        state.cam.position = { 0.5f, 1.5f, 4.0f };
+        state.cam.orientation = minalg::qmul(minalg::rotation_quat(minalg::float3(0, 1, 0), 0.1f), minalg::rotation_quat(minalg::float3(1, 0, 0), -0.35f));
+        transforms[1].position = { -1.5f, 0.0f, -1.0f };
+        transforms[1].orientation = minalg::rotation_quat(minalg::normalize(minalg::float3(1, 1, 0)), 0.6f);
+        transforms[2].position = { 1.5f, 0.5f, -2.0f };
+        transforms[2].scale = { 2.0f, 1.0f, 0.5f };
+    }
+
+    // Run one frame of the script; `render` and the other callbacks of `ctx` receive its geometry
+    void run_frame(tinygizmo::gizmo_context & ctx, int frame)
+    {
+        const int mode = (frame / frames_per_mode) % 3, step = frame % frames_per_mode;
+        state.hotkey_ctrl = step == 0;
+        state.hotkey_translate = step == 0 && mode == 0;
+        state.hotkey_rotate = step == 0 && mode == 1;
+        state.hotkey_scale = step == 0 && mode == 2;
+        state.hotkey_local = step == 0 && (frame / (3 * frames_per_mode)) % 2 == 1; // Toggles at the start of every mode of odd cycles
+
+        // Hover across the gizmo, then press on a handle and drag it
+        if (step == 0) anchor = transforms[0].position;
+        const minalg::float3 grab = anchor + ((mode == 1) ? minalg::float3(0.0f, 1.05f, 0.0f) : minalg::float3(0.6f, 0.0f, 0.0f));
+        minalg::float3 target = anchor + minalg::float3(-1.2f, -0.4f, 0.0f) + minalg::float3(2.4f, 0.8f, 0.0f) * (float(step) / 15.0f);
+        if (step >= 15) target = grab + minalg::float3(0.03f, 0.02f, 0.0f) * float(step - 15);
+        state.mouse_left = step >= 15 && step < 30;
+        state.ray_origin = state.cam.position;
+        state.ray_direction = minalg::normalize(target - state.cam.position);
+
+        ctx.update(state);
+        transform_gizmo("a", ctx, transforms[0]);
+        transform_gizmo("b", ctx, transforms[1]);
+        transform_gizmo("c", ctx, transforms[2]);
+        ctx.draw();
+    }
+};
+
+#endif // end tinygizmo_scene_hpp
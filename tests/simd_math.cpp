@@ -0,0 +1,98 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org>
+
+// The SIMD overloads of minalg enabled by TINYGIZMO_SIMD against the scalar templates they replace, which remain callable with
+// explicit template arguments. Without TINYGIZMO_SIMD both sides are the scalar templates, so build.bat also builds the tests
+// with it defined.
+
+#include "test.hpp"
+#include "../src/tiny-gizmo.hpp"
+#include <algorithm>
+
+using namespace minalg;
+
+namespace
+{
+    // Deterministic inputs: unit quaternions, vectors in [-10,10] and invertible affine and perspective matrices
+    struct inputs
+    {
+        static const int count = 1024;
+        std::vector<float4> quats;
+        std::vector<float3> vec3s;
+        std::vector<float4> vec4s;
+        std::vector<float4x4> mats;
+
+        inputs()
+        {
+            uint32_t state = 12345;
+            auto next = [&]() { state = state * 1664525u + 1013904223u; return float(state >> 8) / float(1 << 24) * 2 - 1; };
+            for (int i = 0; i < count; ++i)
+            {
+                const float4 q = normalize(float4(next(), next(), next(), next()));
+                quats.push_back(q);
+                vec3s.push_back(float3(next(), next(), next()) * 10.0f);
+                vec4s.push_back(float4(next(), next(), next(), next()) * 10.0f);
+                const float3 scale = float3(1.5f) + float3(next(), next(), next());
+                const float4x4 affine = { float4(qxdir(q) * scale.x, 0), float4(qydir(q) * scale.y, 0), float4(qzdir(q) * scale.z, 0), float4(vec3s.back(), 1) };
+                const float4x4 projection = { { 1.2f + next() * 0.1f, 0, 0, 0 }, { 0, 1.6f, 0, 0 }, { 0, 0, -1.001f, -1 }, { 0, 0, -0.02f, 0 } };
+                mats.push_back(i % 2 ? affine : mul<float, 4, 4>(projection, affine));
+            }
+        }
+    };
+
+    const inputs & get_inputs() { static const inputs i; return i; }
+
+    // Largest component-wise difference, relative to the largest component of the reference where it exceeds one
+    template<int M> float max_error(const float * a, const float * reference)
+    {
+        float e = 0, magnitude = 1;
+        for (int i = 0; i < M; ++i) { e = std::max(e, std::abs(a[i] - reference[i])); magnitude = std::max(magnitude, std::abs(reference[i])); }
+        return e / magnitude;
+    }
+    template<int M> float max_error(const vec<float, M> & a, const vec<float, M> & reference) { return max_error<M>(&a.x, &reference.x); }
+    float max_error(const float4x4 & a, const float4x4 & reference) { return max_error<16>(&a.x.x, &reference.x.x); }
+
+    template<class T> float checksum(const T & v) { float s = 0; for (int i = 0; i < int(sizeof(T) / sizeof(float)); ++i) s += (&v.x)[i]; return s; }
+    float checksum(const float4x4 & m) { return checksum(m.x) + checksum(m.y) + checksum(m.z) + checksum(m.w); }
+
+    // Compare an operation over all inputs to its scalar reference, and optionally time both
+    template<class Simd, class Scalar> void compare(const char * name, float tolerance, bool bench, Simd simd, Scalar scalar)
+    {
+        float error = 0;
+        for (int i = 0; i < inputs::count; ++i) error = std::max(error, max_error(simd(i), scalar(i)));
+        if (error > tolerance) std::printf("    %s: error %g exceeds %g\n", name, error, tolerance);
+        CHECK(error <= tolerance);
+        if (!bench) return;
+
+        const double simd_seconds = seconds_per_call([&]() { float s = 0; for (int i = 0; i < inputs::count; ++i) s += checksum(simd(i)); return s; });
+        const double scalar_seconds = seconds_per_call([&]() { float s = 0; for (int i = 0; i < inputs::count; ++i) s += checksum(scalar(i)); return s; });
+        std::printf("    %-20s %10.2f %10.2f %8.2fx %12g\n", name, scalar_seconds * 1e9 / inputs::count, simd_seconds * 1e9 / inputs::count, scalar_seconds / simd_seconds, error);
+    }
+
+    void run(bool bench)
+    {
+        const inputs & in = get_inputs();
+        compare("qmul", 1e-6f, bench, [&](int i) { return qmul(in.quats[i], in.quats[(i + 1) % inputs::count]); }, [&](int i) { return qmul<float>(in.quats[i], in.quats[(i + 1) % inputs::count]); });
+        compare("qrot", 1e-5f, bench, [&](int i) { return qrot(in.quats[i], in.vec3s[i]); }, [&](int i) { return qrot<float>(in.quats[i], in.vec3s[i]); });
+        compare("mul float4x4 float4", 1e-6f, bench, [&](int i) { return mul(in.mats[i], in.vec4s[i]); }, [&](int i) { return mul<float, 4>(in.mats[i], in.vec4s[i]); });
+        compare("mul float4x4 float4x4", 1e-6f, bench, [&](int i) { return mul(in.mats[i], in.mats[(i + 1) % inputs::count]); }, [&](int i) { return mul<float, 4, 4>(in.mats[i], in.mats[(i + 1) % inputs::count]); });
+        // The perspective inputs are poorly conditioned: both paths differ from a double-precision inverse by about 1e-4
+        compare("inverse float4x4", 5e-4f, bench, [&](int i) { return inverse(in.mats[i]); }, [&](int i) { return inverse<float, 4>(in.mats[i]); });
+    }
+}
+
+TEST(simd_math_matches_scalar)
+{
+    run(false);
+}
+
+BENCH(simd_math_per_operation)
+{
+#if defined(TINYGIZMO_SIMD)
+    std::printf("    %-20s %10s %10s %9s %12s\n", "operation", "scalar ns", "simd ns", "speedup", "max error");
+#else
+    std::printf("    TINYGIZMO_SIMD is not defined, so both columns time the scalar templates\n");
+    std::printf("    %-20s %10s %10s %9s %12s\n", "operation", "scalar ns", "scalar ns", "ratio", "max error");
+#endif
+    run(true);
+}
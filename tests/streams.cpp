@@ -0,0 +1,60 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org>
+
+// The structure-of-arrays output of `render_streams` must describe exactly the triangles of the interleaved `render` mesh
+
+#include "test.hpp"
+#include "scene.hpp"
+#include <algorithm>
+#include <array>
+
+using namespace tinygizmo;
+using namespace minalg;
+
+typedef std::array<float, 30> soup_triangle; // Position, normal and color of each corner
+
+// Expand indexed triangles into a sorted list of corner attributes. Degenerate triangles, which pad the unused capacity of the
+// `render` mesh, are dropped, and sorting removes the dependency on the slot layout.
+template<class Vertex> std::vector<soup_triangle> make_soup(const std::vector<uint3> & triangles, Vertex vertex)
+{
+    std::vector<soup_triangle> soup;
+    for (auto & t : triangles)
+    {
+        if (t.x == t.y && t.y == t.z) continue;
+        soup_triangle s;
+        for (int i = 0; i < 3; ++i) vertex(t[i], &s[i * 10]);
+        soup.push_back(s);
+    }
+    std::sort(soup.begin(), soup.end());
+    return soup;
+}
+
+TEST(streams_match_interleaved_mesh)
+{
+    gizmo_context ctx;
+    std::vector<soup_triangle> interleaved, streamed;
+    ctx.render = [&](const geometry_mesh & m)
+    {
+        interleaved = make_soup(m.triangles, [&](uint32_t i, float * out)
+        {
+            const geometry_vertex & v = m.vertices[i];
+            std::copy(&v.position.x, &v.position.x + 3, out); std::copy(&v.normal.x, &v.normal.x + 3, out + 3); std::copy(&v.color.x, &v.color.x + 4, out + 6);
+        });
+    };
+    ctx.render_streams = [&](const geometry_streams & s)
+    {
+        CHECK(s.positions.size() == s.normals.size() && s.positions.size() == s.colors.size());
+        streamed = make_soup(s.triangles, [&](uint32_t i, float * out)
+        {
+            std::copy(&s.positions[i].x, &s.positions[i].x + 3, out); std::copy(&s.normals[i].x, &s.normals[i].x + 3, out + 3); std::copy(&s.colors[i].x, &s.colors[i].x + 4, out + 6);
+        });
+    };
+
+    test_scene scene;
+    for (int frame = 0; frame < 6 * test_scene::frames_per_mode; ++frame)
+    {
+        scene.run_frame(ctx, frame);
+        CHECK(!interleaved.empty());
+        CHECK(interleaved == streamed);
+    }
+}
@@ -0,0 +1,52 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org>
+
+// Minimal test and benchmark registry. Each file in tests/ registers its cases with TEST(name) or BENCH(name); main.cpp
+// runs every test, and every benchmark when passed --bench. A failed CHECK reports its location and fails the run.
+
+#pragma once
+
+#ifndef tinygizmo_test_hpp
+#define tinygizmo_test_hpp
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+struct test_case { const char * name; void (*run)(); bool bench; };
+
+inline std::vector<test_case> & test_cases() { static std::vector<test_case> cases; return cases; }
+inline int & test_failures() { static int failures = 0; return failures; }
+
+struct test_registrar { test_registrar(const char * name, void (*run)(), bool bench) { test_cases().push_back({ name, run, bench }); } };
+
+#define TINYGIZMO_TEST_CASE(name, bench) static void name(); static const test_registrar name##_registrar(#name, name, bench); static void name()
+#define TEST(name) TINYGIZMO_TEST_CASE(name, false)
+#define BENCH(name) TINYGIZMO_TEST_CASE(name, true)
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s(%d): CHECK(%s) failed\n", __FILE__, __LINE__, #condition); ++test_failures(); } } while (0)
+
+// Benchmarks store the results they would otherwise discard here; a volatile write cannot be removed by the compiler
+inline volatile float & bench_sink() { static volatile float sink = 0; return sink; }
+
+// Average seconds per call of `f`, which is repeated for at least 0.2s. `f` should return a value derived from its work, which is
+// accumulated into bench_sink() so that the compiler cannot remove the work.
+template<class F> double seconds_per_call(F f)
+{
+    typedef std::chrono::high_resolution_clock clock;
+    float accumulator = 0;
+    uint64_t calls = 0;
+    const auto start = clock::now();
+    std::chrono::duration<double> elapsed(0);
+    for (uint64_t batch = 1; elapsed.count() < 0.2; batch *= 2)
+    {
+        for (uint64_t i = 0; i < batch; ++i) accumulator += f();
+        calls += batch;
+        elapsed = clock::now() - start;
+    }
+    bench_sink() = accumulator;
+    return elapsed.count() / double(calls);
+}
+
+#endif // end tinygizmo_test_hpp
@@ -0,0 +1,103 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org>
+
+// The batched vertex transform used by `emit(...)`: normals must stay perpendicular to their faces under non-uniform and mirroring
+// scales, projective transforms must divide by w, and the benchmark reports vertices per second for every kernel tier
+
+#include "test.hpp"
+#include "../src/tiny-gizmo.hpp"
+#include <algorithm>
+
+using namespace tinygizmo;
+using namespace minalg;
+
+// Defined in tiny-gizmo.cpp. The SSE2 and AVX kernels may only be called if `detect_cpu_tier()` reports them.
+void transform_vertices(const float4x4 & transform, const float4x4 & model, std::vector<geometry_vertex> & vertices);
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+void transform_vertices_sse2(const float4x4 & transform, const float4x4 & model, std::vector<geometry_vertex> & vertices);
+void transform_vertices_avx(const float4x4 & transform, const float4x4 & model, std::vector<geometry_vertex> & vertices);
+#endif
+geometry_mesh make_box_geometry(const float3 & min_bounds, const float3 & max_bounds);
+geometry_mesh make_lathed_geometry(const float3 & axis, const float3 & arm1, const float3 & arm2, int slices, const std::vector<float2> & points, const float eps);
+
+static float4x4 make_model(const float4 & orientation, const float3 & scale, const float3 & position)
+{
+    return{ float4(qxdir(orientation) * scale.x, 0), float4(qydir(orientation) * scale.y, 0), float4(qzdir(orientation) * scale.z, 0), float4(position, 1) };
+}
+
+TEST(transform_vertices_keeps_normals_perpendicular)
+{
+    const geometry_mesh box = make_box_geometry({ -1, -2, -0.5f }, { 1, 0.5f, 2 });
+    const float4 orientation = rotation_quat(normalize(float3(1, 2, 3)), 0.7f);
+    for (const float3 scale : { float3(1, 1, 1), float3(3, 0.5f, 1.5f), float3(-2, 1, 0.25f) })
+    {
+        const float4x4 model = make_model(orientation, scale, { 1, 2, 3 });
+        geometry_mesh m = box;
+        transform_vertices(model, model, m.vertices);
+        for (size_t i = 0; i < m.triangles.size(); ++i)
+        {
+            // A mirroring scale flips the winding, so the face normal is compared with the sign it had before the transform
+            const uint3 t = m.triangles[i];
+            const float3 before = cross(box.vertices[t.y].position - box.vertices[t.x].position, box.vertices[t.z].position - box.vertices[t.x].position);
+            const float3 after = normalize(cross(m.vertices[t.y].position - m.vertices[t.x].position, m.vertices[t.z].position - m.vertices[t.x].position));
+            const float sign = (dot(before, box.vertices[t.x].normal) > 0) == (scale.x * scale.y * scale.z > 0) ? 1.0f : -1.0f;
+            for (int j = 0; j < 3; ++j)
+            {
+                CHECK(std::abs(length(m.vertices[t[j]].normal) - 1) < 1e-5f);
+                CHECK(dot(m.vertices[t[j]].normal, after) * sign > 1 - 1e-5f);
+            }
+        }
+        for (size_t i = 0; i < m.vertices.size(); ++i) CHECK(length(m.vertices[i].position - mul(model, float4(box.vertices[i].position, 1)).xyz()) < 1e-5f);
+    }
+}
+
+TEST(transform_vertices_divides_projective_positions)
+{
+    const float4x4 model = make_model(rotation_quat(float3(0, 1, 0), 0.3f), float3(2), { 0, 0, -5 });
+    const float4x4 projection = { { 1.2f, 0, 0, 0 }, { 0, 1.6f, 0, 0 }, { 0, 0, -1.001f, -1 }, { 0, 0, -0.02f, 0 } };
+    const float4x4 transform = mul(projection, model);
+    const geometry_mesh box = make_box_geometry({ -1, -1, -1 }, { 1, 1, 1 });
+    geometry_mesh m = box;
+    transform_vertices(transform, model, m.vertices);
+    for (size_t i = 0; i < m.vertices.size(); ++i)
+    {
+        const float4 clip = mul(transform, float4(box.vertices[i].position, 1));
+        CHECK(length(m.vertices[i].position - clip.xyz() / clip.w) < 1e-5f);
+    }
+}
+
+BENCH(transform_vertices_per_second)
+{
+    // An arrow of the finest level of detail, repeated to a batch of about 64k vertices. Each call copies the batch first, as `emit(...)`
+    // copies the component mesh before transforming it.
+    const std::vector<float2> arrow_points = { { 0.25f, 0 }, { 0.25f, 0.05f },{ 1, 0.05f },{ 1, 0.10f },{ 1.2f, 0 } };
+    const geometry_mesh arrow = make_lathed_geometry({ 1,0,0 },{ 0,1,0 },{ 0,0,1 }, 16, arrow_points, 0.0f);
+    std::vector<geometry_vertex> source;
+    while (source.size() < 65536) source.insert(source.end(), arrow.vertices.begin(), arrow.vertices.end());
+
+    const float4x4 model = make_model(rotation_quat(normalize(float3(1, 2, 3)), 0.7f), { 3, 0.5f, 1.5f }, { 1, 2, 3 });
+    const float4x4 projection = { { 1.2f, 0, 0, 0 }, { 0, 1.6f, 0, 0 }, { 0, 0, -1.001f, -1 }, { 0, 0, -0.02f, 0 } };
+
+    typedef void (*kernel)(const float4x4 &, const float4x4 &, std::vector<geometry_vertex> &);
+    struct tier { const char * name; kernel k; bool supported; };
+    std::vector<tier> tiers = { { "scalar", transform_vertices, true } };
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    tiers.push_back({ "sse2", transform_vertices_sse2, detect_cpu_tier() >= cpu_tier::sse2 });
+    tiers.push_back({ "avx", transform_vertices_avx, detect_cpu_tier() >= cpu_tier::avx });
+#endif
+
+    std::printf("    %-8s %16s %16s\n", "tier", "affine Mvert/s", "projective Mvert/s");
+    std::vector<geometry_vertex> vertices;
+    for (auto & t : tiers)
+    {
+        if (!t.supported) { std::printf("    %-8s not supported by this CPU\n", t.name); continue; }
+        double rates[2];
+        for (int projective = 0; projective < 2; ++projective)
+        {
+            const float4x4 transform = projective ? mul(projection, model) : model;
+            const double seconds = seconds_per_call([&]() { vertices = source; t.k(transform, model, vertices); return vertices.back().position.x; });
+            rates[projective] = double(source.size()) / seconds * 1e-6;
+        }
+        std::printf("    %-8s %16.1f %16.1f\n", t.name, rates[0], rates[1]);
+    }
+}